@@ -0,0 +1,215 @@
+#include "analytics.hpp"
+#include "journal.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+using namespace std;
+
+AnalyticsReport::AnalyticsReport() : sources(0), entries(0), corruptBlocks(0), dwellCount(), dwellTotal(), dwellMax(), dwellBuckets(),
+    transitions(), cycles(0), cycleTotal(0), cycleMin(UINT64_MAX), cycleMax(0), cycleBuckets(), errorBursts(0), escalations(0), escalationErrors(0) {}
+
+void AnalyticsReport::merge(const AnalyticsReport &o) {
+    sources += o.sources;
+    entries += o.entries;
+    corruptBlocks += o.corruptBlocks;
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        dwellCount[s] += o.dwellCount[s];
+        dwellTotal[s] += o.dwellTotal[s];
+        dwellMax[s] = max(dwellMax[s], o.dwellMax[s]);
+        for (size_t b = 0; b < ANALYTICS_BUCKETS; b++) dwellBuckets[s][b] += o.dwellBuckets[s][b];
+        for (size_t t = 0; t < STATE_COUNT; t++) transitions[s][t] += o.transitions[s][t];
+    }
+    cycles += o.cycles;
+    cycleTotal += o.cycleTotal;
+    cycleMin = min(cycleMin, o.cycleMin);
+    cycleMax = max(cycleMax, o.cycleMax);
+    for (size_t b = 0; b < ANALYTICS_BUCKETS; b++) cycleBuckets[b] += o.cycleBuckets[b];
+    errorBursts += o.errorBursts;
+    escalations += o.escalations;
+    escalationErrors += o.escalationErrors;
+}
+
+static size_t bucketOf(uint64_t nanos) {
+    size_t bucket = nanos == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(nanos));
+    return bucket < ANALYTICS_BUCKETS ? bucket : ANALYTICS_BUCKETS - 1;
+}
+
+// Fold satu history entry demi entry ke sebuah report
+class HistoryFold {
+
+    private:
+    AnalyticsReport &report;
+    const AnalyticsOptions &options;
+    bool hasPrevious;
+    SystemState previous;
+    uint64_t previousTime;
+    bool inCycle;               // A MOVEMENT was entered since the last SHOOTING
+    uint64_t cycleStart;
+    uint32_t burstErrors;       // Errors in the current burst
+    uint64_t lastError;
+
+    public:
+    HistoryFold(AnalyticsReport &r, const AnalyticsOptions &o)
+        : report(r), options(o), hasPrevious(false), previous(SystemState::INIT), previousTime(0), inCycle(false), cycleStart(0),
+          burstErrors(0), lastError(0) {}
+
+    // count false hanya memperbarui konteks, untuk pemanasan chunk journal
+    void feed(SystemState state, uint64_t time, bool count) {
+        if (count) report.entries++;
+        if (hasPrevious && count) {
+            size_t p = static_cast<size_t>(previous);
+            uint64_t dwell = time > previousTime ? time - previousTime : 0;
+            report.dwellCount[p]++;
+            report.dwellTotal[p] += dwell;
+            report.dwellMax[p] = max(report.dwellMax[p], dwell);
+            report.dwellBuckets[p][bucketOf(dwell)]++;
+            report.transitions[p][static_cast<size_t>(state)]++;
+        }
+        switch (state) {
+            case SystemState::MOVEMENT:
+                if (!inCycle) cycleStart = time;
+                inCycle = true;
+                break;
+            case SystemState::SHOOTING:
+                if (inCycle && count) {
+                    uint64_t cycle = time > cycleStart ? time - cycleStart : 0;
+                    report.cycles++;
+                    report.cycleTotal += cycle;
+                    report.cycleMin = min(report.cycleMin, cycle);
+                    report.cycleMax = max(report.cycleMax, cycle);
+                    report.cycleBuckets[bucketOf(cycle)]++;
+                }
+                inCycle = false;
+                break;
+            case SystemState::ERROR:
+                burstErrors = burstErrors > 0 && time - lastError <= options.burstWindowNs ? burstErrors + 1 : 1;
+                lastError = time;
+                if (burstErrors == options.burstSize && count) report.errorBursts++;
+                break;
+            case SystemState::STOPPED:
+                if (hasPrevious && previous == SystemState::ERROR && count) {
+                    report.escalations++;
+                    report.escalationErrors += burstErrors;
+                }
+                inCycle = false;
+                burstErrors = 0;
+                break;
+            case SystemState::INIT:
+                inCycle = false;
+                burstErrors = 0;
+                break;
+            default:
+                break;
+        }
+        hasPrevious = true;
+        previous = state;
+        previousTime = time;
+    }
+};
+
+// Jalankan task 0..count-1 di beberapa thread, masing-masing dengan report parsial sendiri
+template <class Fn>
+static AnalyticsReport runParallel(size_t count, size_t threads, Fn fn) {
+    if (threads == 0) threads = max<unsigned>(1, thread::hardware_concurrency());
+    threads = max<size_t>(1, min(threads, count));
+    vector<AnalyticsReport> partials(threads);
+    atomic<size_t> next(0);
+    auto worker = [&](size_t id) {
+        for (size_t task = next.fetch_add(1, memory_order_relaxed); task < count; task = next.fetch_add(1, memory_order_relaxed)) {
+            fn(task, partials[id]);
+        }
+    };
+    vector<thread> pool;
+    for (size_t id = 1; id < threads; id++) pool.emplace_back(worker, id);
+    worker(0);
+    for (thread &t : pool) t.join();
+    AnalyticsReport total;
+    for (const AnalyticsReport &partial : partials) total.merge(partial);
+    return total;
+}
+
+AnalyticsReport analyzeHistories(const vector<vector<HistoryEntry>> &histories, const AnalyticsOptions &options) {
+    return runParallel(histories.size(), options.threads, [&](size_t task, AnalyticsReport &partial) {
+        HistoryFold fold(partial, options);
+        for (const HistoryEntry &entry : histories[task]) fold.feed(entry.first, entry.second, true);
+        partial.sources++;
+    });
+}
+
+static void feedBlock(HistoryFold &fold, const JournalBlock &blk, bool count) {
+    uint32_t n = min<uint32_t>(blk.count, JOURNAL_RECORDS_PER_BLOCK);
+    for (uint32_t r = 0; r < n; r++) {
+        if (blk.records[r].state < STATE_COUNT) fold.feed(static_cast<SystemState>(blk.records[r].state), blk.records[r].timestamp, count);
+    }
+}
+
+AnalyticsReport analyzeJournals(const vector<string> &paths, const AnalyticsOptions &options) {
+    struct Chunk {
+        size_t journal;
+        size_t begin;
+        size_t end;
+    };
+    vector<unique_ptr<JournalReader>> readers;
+    vector<Chunk> chunks;
+    size_t chunkBlocks = max<size_t>(1, options.journalChunkBlocks);
+    for (const string &path : paths) {
+        unique_ptr<JournalReader> reader(new JournalReader());
+        if (!reader->open(path)) continue;
+        for (size_t b = 0; b < reader->blockCount(); b += chunkBlocks) {
+            chunks.push_back({readers.size(), b, min(b + chunkBlocks, reader->blockCount())});
+        }
+        readers.push_back(move(reader));
+    }
+    AnalyticsReport report = runParallel(chunks.size(), options.threads, [&](size_t task, AnalyticsReport &partial) {
+        const Chunk &chunk = chunks[task];
+        const JournalReader &reader = *readers[chunk.journal];
+        HistoryFold fold(partial, options);
+        if (chunk.begin > 0 && reader.verify(chunk.begin - 1)) feedBlock(fold, reader.block(chunk.begin - 1), false);
+        for (size_t b = chunk.begin; b < chunk.end; b++) {
+            if (!reader.verify(b)) {
+                partial.corruptBlocks++;
+                continue;
+            }
+            feedBlock(fold, reader.block(b), true);
+        }
+    });
+    report.sources = readers.size();
+    return report;
+}
+
+void printReport(ostream &out, const AnalyticsReport &r) {
+    char line[192];
+    snprintf(line, sizeof(line), "[Analytics] Sources=%llu Entries=%llu CorruptBlocks=%llu\n", static_cast<unsigned long long>(r.sources),
+             static_cast<unsigned long long>(r.entries), static_cast<unsigned long long>(r.corruptBlocks));
+    out << line;
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        if (r.dwellCount[s] == 0) continue;
+        // Median kira-kira: batas atas bucket tempat separuh kunjungan tercapai
+        uint64_t seen = 0;
+        size_t median = 0;
+        while (median < ANALYTICS_BUCKETS && (seen += r.dwellBuckets[s][median]) * 2 < r.dwellCount[s]) median++;
+        snprintf(line, sizeof(line), "[Analytics] %-12s visits=%llu mean=%.3fms max=%.3fms median<%.3fms\n", STATE_NAMES[s],
+                 static_cast<unsigned long long>(r.dwellCount[s]), r.dwellTotal[s] / 1e6 / r.dwellCount[s], r.dwellMax[s] / 1e6,
+                 static_cast<double>(1ULL << min<size_t>(median, 63)) / 1e6);
+        out << line;
+    }
+    if (r.cycles > 0) {
+        snprintf(line, sizeof(line), "[Analytics] Cycles MOVEMENT->SHOOTING=%llu mean=%.3fms min=%.3fms max=%.3fms\n",
+                 static_cast<unsigned long long>(r.cycles), r.cycleTotal / 1e6 / r.cycles, r.cycleMin / 1e6, r.cycleMax / 1e6);
+        out << line;
+    }
+    snprintf(line, sizeof(line), "[Analytics] ErrorBursts=%llu Escalations=%llu ErrorsPerEscalation=%.2f\n",
+             static_cast<unsigned long long>(r.errorBursts), static_cast<unsigned long long>(r.escalations),
+             r.escalations ? static_cast<double>(r.escalationErrors) / r.escalations : 0.0);
+    out << line;
+    out << "[Analytics] Transitions (from -> to):";
+    for (size_t f = 0; f < STATE_COUNT; f++) {
+        for (size_t t = 0; t < STATE_COUNT; t++) {
+            if (r.transitions[f][t]) out << " " << STATE_NAMES[f] << "->" << STATE_NAMES[t] << "=" << r.transitions[f][t];
+        }
+    }
+    out << "\n";
+}
@@ -0,0 +1,76 @@
+#ifndef ANALYTICS_H_
+#define ANALYTICS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "state.hpp"
+#include "history.hpp"
+
+using namespace std;
+
+const size_t ANALYTICS_BUCKETS = 48;    // Bucket i counts durations shorter than 2^i nanoseconds
+
+/**
+ * @brief Options of the history analytics.
+ */
+struct AnalyticsOptions {
+        uint64_t burstWindowNs = 10000000000ULL;        // ERROR entries closer than this belong to the same burst
+        uint32_t burstSize = 2;                         // Errors in a burst for it to count as one
+        size_t threads = 0;                             // Worker threads, 0 for one per core
+        size_t journalChunkBlocks = 4096;               // Journal blocks per task when splitting a large journal
+};
+
+/**
+ * @brief Aggregate statistics over many histories, all durations in nanoseconds.
+ * Partial reports computed by different threads are combined with merge().
+ */
+struct AnalyticsReport {
+        uint64_t sources;                                       // Histories or journals analyzed
+        uint64_t entries;                                       // History entries analyzed
+        uint64_t corruptBlocks;                                 // Journal blocks skipped because of a bad checksum
+        uint64_t dwellCount[STATE_COUNT];                       // Finished visits of each state
+        uint64_t dwellTotal[STATE_COUNT];
+        uint64_t dwellMax[STATE_COUNT];
+        uint64_t dwellBuckets[STATE_COUNT][ANALYTICS_BUCKETS];  // Log2 distribution of the visit durations
+        uint64_t transitions[STATE_COUNT][STATE_COUNT];         // [from][to] transition counts
+        uint64_t cycles;                                        // MOVEMENT to SHOOTING cycles, first move to the shot
+        uint64_t cycleTotal;
+        uint64_t cycleMin;
+        uint64_t cycleMax;
+        uint64_t cycleBuckets[ANALYTICS_BUCKETS];
+        uint64_t errorBursts;                                   // Bursts of at least burstSize errors
+        uint64_t escalations;                                   // ERROR to STOPPED transitions
+        uint64_t escalationErrors;                              // Errors of the bursts ending in STOPPED
+
+        AnalyticsReport();
+
+        /**
+         * @brief Add the counts of another report.
+         */
+        void merge(const AnalyticsReport &other);
+};
+
+/**
+ * @brief Analyze histories in parallel, each history being one robot.
+ * Every worker folds whole histories into its own partial report, the partials are merged at the end.
+ */
+AnalyticsReport analyzeHistories(const vector<vector<HistoryEntry>> &histories, const AnalyticsOptions &options = AnalyticsOptions());
+
+/**
+ * @brief Analyze binary journals in parallel, each journal being one robot.
+ * Journals are mapped read-only and split into chunks of options.journalChunkBlocks blocks, so a single multi-GB
+ * journal also uses every core. A chunk first replays the block before it without counting, to know the state
+ * the robot was in, counts are then exact except for cycles and bursts longer than a block that cross a chunk start.
+ * @note Journals that cannot be opened are skipped and not counted in sources.
+ */
+AnalyticsReport analyzeJournals(const vector<string> &paths, const AnalyticsOptions &options = AnalyticsOptions());
+
+/**
+ * @brief Write a report as a human readable summary.
+ */
+void printReport(ostream &out, const AnalyticsReport &report);
+
+#endif // ANALYTICS_H_
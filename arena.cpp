@@ -0,0 +1,36 @@
+#include "arena.hpp"
+
+using namespace std;
+
+// Konstruktor, buffer pertama langsung dialokasikan saat dipakai
+FSMArena::FSMArena(size_t initialBytes) : resource(initialBytes), machines(&resource) {}
+
+FSMArena::~FSMArena() { release(); }
+
+FSM &FSMArena::create(uint32_t delay, size_t historyCapacity) {
+    pmr::polymorphic_allocator<FSM> allocator(&resource);
+    FSM *fsm = allocator.allocate(1);
+    new (fsm) FSM(delay, historyCapacity, &resource);
+    machines.push_back(fsm);
+    return *fsm;
+}
+
+FSM &FSMArena::create(const FsmConfig &config) {
+    pmr::polymorphic_allocator<FSM> allocator(&resource);
+    FSM *fsm = allocator.allocate(1);
+    new (fsm) FSM(config, &resource);
+    machines.push_back(fsm);
+    return *fsm;
+}
+
+// Destruktor tiap FSM, lalu seluruh memori arena dilepas sekaligus
+void FSMArena::release() {
+    for (FSM *fsm : machines) fsm->~FSM();
+    machines.clear();
+    machines.shrink_to_fit();
+    resource.release();
+}
+
+size_t FSMArena::size() const { return machines.size(); }
+FSM &FSMArena::at(size_t index) const { return *machines[index]; }
+pmr::memory_resource *FSMArena::getResource() { return &resource; }
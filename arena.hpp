@@ -0,0 +1,64 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include "fsm.hpp"
+
+using namespace std;
+
+/**
+ * @brief Monotonic arena holding a sweep of FSMs and their histories.
+ * Every FSM object, history entry and bookkeeping pointer comes from one monotonic_buffer_resource,
+ * so creating an FSM is a pointer bump and release() frees the whole sweep in one shot instead of one free per history.
+ * @note Memory freed by a single FSM (a growing unbounded history) is only reclaimed by release(),
+ * give the FSMs a historyCapacity to keep the arena from growing.
+ */
+class FSMArena {
+
+        private:
+        pmr::monotonic_buffer_resource resource;
+        pmr::vector<FSM *> machines;
+
+        public:
+        /**
+         * @brief Create an empty arena.
+         * @param initialBytes Size of the first buffer, later buffers grow geometrically.
+         */
+        explicit FSMArena(size_t initialBytes = 1 << 20);
+
+        /**
+         * @brief Release the arena, see release().
+         */
+        ~FSMArena();
+
+        FSMArena(const FSMArena &) = delete;
+        FSMArena &operator=(const FSMArena &) = delete;
+
+        /**
+         * @brief Construct an FSM in the arena, with its histories allocated from the arena too.
+         * @return The FSM, valid until release().
+         */
+        FSM &create(uint32_t delay, size_t historyCapacity = 0);
+
+        /**
+         * @brief Construct an FSM from a config in the arena, see FSM(const FsmConfig &, pmr::memory_resource *).
+         */
+        FSM &create(const FsmConfig &config);
+
+        /**
+         * @brief Run the destructor of every FSM, then give all the arena memory back at once.
+         */
+        void release();
+
+        size_t size() const;
+        FSM &at(size_t index) const;
+
+        /**
+         * @brief Get the memory resource of the arena, for other allocations of the same sweep.
+         */
+        pmr::memory_resource *getResource();
+};
+
+#endif // ARENA_H_
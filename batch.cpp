@@ -0,0 +1,246 @@
+#include "batch.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FSM_BATCH_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FSM_BATCH_NEON 1
+#endif
+
+using namespace std;
+
+static const uint8_t S_INIT = static_cast<uint8_t>(SystemState::INIT);
+static const uint8_t S_IDLE = static_cast<uint8_t>(SystemState::IDLE);
+static const uint8_t S_MOVEMENT = static_cast<uint8_t>(SystemState::MOVEMENT);
+static const uint8_t S_SHOOTING = static_cast<uint8_t>(SystemState::SHOOTING);
+static const uint8_t S_CALCULATION = static_cast<uint8_t>(SystemState::CALCULATION);
+static const uint8_t S_ERROR = static_cast<uint8_t>(SystemState::ERROR);
+static const uint8_t S_STOPPED = static_cast<uint8_t>(SystemState::STOPPED);
+
+// State tujuan dari IDLE untuk tiap Event, sama dengan TransitionTable::defaultTable()
+static const int32_t IDLE_TARGET[8] = {
+    S_IDLE,         // TICK
+    S_IDLE,         // STATUS
+    S_MOVEMENT,     // MOVE
+    S_SHOOTING,     // SHOOT
+    S_CALCULATION,  // CALC
+    S_STOPPED,      // STOP
+    S_ERROR,        // INVALID
+    S_IDLE
+};
+
+FSMBatch::FSMBatch(size_t count)
+    : states(count, S_INIT), moveCounts(count, 0), errorCounts(count, 0), lastHeartbeats(count, 0),
+      transitionCounts(count, 0), forceScalar(false) {}
+
+size_t FSMBatch::size() const { return states.size(); }
+void FSMBatch::setForceScalar(bool scalar) { forceScalar = scalar; }
+
+// Versi skalar, juga dipakai untuk sisa elemen di luar lebar vektor
+void FSMBatch::stepScalar(const Event *events, uint32_t now, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        uint8_t s = states[i];
+        uint8_t next = s;
+        switch (s) {
+            case S_INIT:        next = S_IDLE; break;
+            case S_IDLE:        next = static_cast<uint8_t>(IDLE_TARGET[static_cast<uint8_t>(events[i]) & 7]); break;
+            case S_MOVEMENT:    moveCounts[i]++; next = moveCounts[i] >= 3 ? S_SHOOTING : S_IDLE; break;
+            case S_SHOOTING:    moveCounts[i] = 0; next = S_IDLE; break;
+            case S_CALCULATION: next = moveCounts[i] == 0 ? S_ERROR : S_IDLE; break;
+            case S_ERROR:       errorCounts[i]++; next = errorCounts[i] > 3 ? S_STOPPED : S_IDLE; break;
+            default: break;
+        }
+        if (next != s) {
+            states[i] = next;
+            lastHeartbeats[i] = now;
+            transitionCounts[i]++;
+        }
+    }
+}
+
+#if FSM_BATCH_X86
+// 8 mesin per iterasi, semua guard diganti dengan compare dan blend
+__attribute__((target("avx2")))
+static size_t stepAvx2(uint8_t *states, int32_t *moves, int32_t *errors, uint32_t *heartbeats, uint64_t *transitions,
+                       const Event *events, uint32_t now, size_t count) {
+    const __m256i idleTarget = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(IDLE_TARGET));
+    const __m256i vInit = _mm256_set1_epi32(S_INIT);
+    const __m256i vIdle = _mm256_set1_epi32(S_IDLE);
+    const __m256i vMovement = _mm256_set1_epi32(S_MOVEMENT);
+    const __m256i vShooting = _mm256_set1_epi32(S_SHOOTING);
+    const __m256i vCalculation = _mm256_set1_epi32(S_CALCULATION);
+    const __m256i vError = _mm256_set1_epi32(S_ERROR);
+    const __m256i vStopped = _mm256_set1_epi32(S_STOPPED);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i vNow = _mm256_set1_epi32(static_cast<int32_t>(now));
+    const __m256i narrow = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(states + i)));
+        __m256i e = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(events + i)));
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(moves + i));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(errors + i));
+        __m256i hb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(heartbeats + i));
+
+        __m256i isInit = _mm256_cmpeq_epi32(s, vInit);
+        __m256i isIdle = _mm256_cmpeq_epi32(s, vIdle);
+        __m256i isMovement = _mm256_cmpeq_epi32(s, vMovement);
+        __m256i isShooting = _mm256_cmpeq_epi32(s, vShooting);
+        __m256i isCalculation = _mm256_cmpeq_epi32(s, vCalculation);
+        __m256i isError = _mm256_cmpeq_epi32(s, vError);
+
+        __m256i m1 = _mm256_add_epi32(m, one);
+        __m256i r1 = _mm256_add_epi32(r, one);
+        __m256i movementNext = _mm256_blendv_epi8(vIdle, vShooting, _mm256_cmpgt_epi32(m1, two));
+        __m256i calculationNext = _mm256_blendv_epi8(vIdle, vError, _mm256_cmpeq_epi32(m, zero));
+        __m256i errorNext = _mm256_blendv_epi8(vIdle, vStopped, _mm256_cmpgt_epi32(r1, three));
+
+        __m256i next = s;
+        next = _mm256_blendv_epi8(next, vIdle, isInit);
+        next = _mm256_blendv_epi8(next, _mm256_permutevar8x32_epi32(idleTarget, e), isIdle);
+        next = _mm256_blendv_epi8(next, movementNext, isMovement);
+        next = _mm256_blendv_epi8(next, vIdle, isShooting);
+        next = _mm256_blendv_epi8(next, calculationNext, isCalculation);
+        next = _mm256_blendv_epi8(next, errorNext, isError);
+
+        m = _mm256_blendv_epi8(m, m1, isMovement);
+        m = _mm256_andnot_si256(isShooting, m);
+        r = _mm256_blendv_epi8(r, r1, isError);
+
+        __m256i changed = _mm256_xor_si256(_mm256_cmpeq_epi32(next, s), _mm256_set1_epi32(-1));
+        hb = _mm256_blendv_epi8(hb, vNow, changed);
+        __m256i tLo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(transitions + i));
+        __m256i tHi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(transitions + i + 4));
+        tLo = _mm256_sub_epi64(tLo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(changed)));
+        tHi = _mm256_sub_epi64(tHi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(changed, 1)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(moves + i), m);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(errors + i), r);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(heartbeats + i), hb);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(transitions + i), tLo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(transitions + i + 4), tHi);
+
+        __m256i packed = _mm256_shuffle_epi8(next, narrow);
+        uint32_t lo = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_castsi256_si128(packed)));
+        uint32_t hi = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1)));
+        memcpy(states + i, &lo, 4);
+        memcpy(states + i + 4, &hi, 4);
+    }
+    return i;
+}
+
+static bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+#if FSM_BATCH_NEON
+// 4 mesin per iterasi
+static size_t stepNeon(uint8_t *states, int32_t *moves, int32_t *errors, uint32_t *heartbeats, uint64_t *transitions,
+                       const Event *events, uint32_t now, size_t count) {
+    const uint32x4_t vIdle = vdupq_n_u32(S_IDLE);
+    const uint32x4_t vShooting = vdupq_n_u32(S_SHOOTING);
+    const uint32x4_t vError = vdupq_n_u32(S_ERROR);
+    const uint32x4_t vStopped = vdupq_n_u32(S_STOPPED);
+    const uint32x4_t vNow = vdupq_n_u32(now);
+    const int32x4_t one = vdupq_n_s32(1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t sRaw[4] = {states[i], states[i + 1], states[i + 2], states[i + 3]};
+        uint32_t idleRaw[4];
+        for (int k = 0; k < 4; k++) idleRaw[k] = static_cast<uint32_t>(IDLE_TARGET[static_cast<uint8_t>(events[i + k]) & 7]);
+        uint32x4_t s = vld1q_u32(sRaw);
+        int32x4_t m = vld1q_s32(moves + i);
+        int32x4_t r = vld1q_s32(errors + i);
+        uint32x4_t hb = vld1q_u32(heartbeats + i);
+
+        uint32x4_t isInit = vceqq_u32(s, vdupq_n_u32(S_INIT));
+        uint32x4_t isIdle = vceqq_u32(s, vIdle);
+        uint32x4_t isMovement = vceqq_u32(s, vdupq_n_u32(S_MOVEMENT));
+        uint32x4_t isShooting = vceqq_u32(s, vShooting);
+        uint32x4_t isCalculation = vceqq_u32(s, vdupq_n_u32(S_CALCULATION));
+        uint32x4_t isError = vceqq_u32(s, vError);
+
+        int32x4_t m1 = vaddq_s32(m, one);
+        int32x4_t r1 = vaddq_s32(r, one);
+        uint32x4_t movementNext = vbslq_u32(vcgtq_s32(m1, vdupq_n_s32(2)), vShooting, vIdle);
+        uint32x4_t calculationNext = vbslq_u32(vceqq_s32(m, vdupq_n_s32(0)), vError, vIdle);
+        uint32x4_t errorNext = vbslq_u32(vcgtq_s32(r1, vdupq_n_s32(3)), vStopped, vIdle);
+
+        uint32x4_t next = s;
+        next = vbslq_u32(isInit, vIdle, next);
+        next = vbslq_u32(isIdle, vld1q_u32(idleRaw), next);
+        next = vbslq_u32(isMovement, movementNext, next);
+        next = vbslq_u32(isShooting, vIdle, next);
+        next = vbslq_u32(isCalculation, calculationNext, next);
+        next = vbslq_u32(isError, errorNext, next);
+
+        m = vbslq_s32(isMovement, m1, m);
+        m = vbslq_s32(isShooting, vdupq_n_s32(0), m);
+        r = vbslq_s32(isError, r1, r);
+
+        uint32x4_t changed = vmvnq_u32(vceqq_u32(next, s));
+        hb = vbslq_u32(changed, vNow, hb);
+        uint64x2_t tLo = vld1q_u64(transitions + i);
+        uint64x2_t tHi = vld1q_u64(transitions + i + 2);
+        tLo = vaddq_u64(tLo, vmovl_u32(vget_low_u32(vandq_u32(changed, vdupq_n_u32(1)))));
+        tHi = vaddq_u64(tHi, vmovl_u32(vget_high_u32(vandq_u32(changed, vdupq_n_u32(1)))));
+
+        vst1q_s32(moves + i, m);
+        vst1q_s32(errors + i, r);
+        vst1q_u32(heartbeats + i, hb);
+        vst1q_u64(transitions + i, tLo);
+        vst1q_u64(transitions + i + 2, tHi);
+        uint32_t out[4];
+        vst1q_u32(out, next);
+        for (int k = 0; k < 4; k++) states[i + k] = static_cast<uint8_t>(out[k]);
+    }
+    return i;
+}
+#endif
+
+void FSMBatch::step(const Event *events, uint32_t now) {
+    size_t done = 0;
+    if (!forceScalar) {
+#if FSM_BATCH_X86
+        if (hasAvx2()) {
+            done = stepAvx2(states.data(), moveCounts.data(), errorCounts.data(), lastHeartbeats.data(),
+                            transitionCounts.data(), events, now, states.size());
+        }
+#elif FSM_BATCH_NEON
+        done = stepNeon(states.data(), moveCounts.data(), errorCounts.data(), lastHeartbeats.data(),
+                        transitionCounts.data(), events, now, states.size());
+#endif
+    }
+    stepScalar(events, now, done, states.size());
+}
+
+void FSMBatch::step(const vector<Event> &events, uint32_t now) { step(events.data(), now); }
+
+const char *FSMBatch::backend() const {
+    if (forceScalar) return "scalar";
+#if FSM_BATCH_X86
+    if (hasAvx2()) return "avx2";
+#elif FSM_BATCH_NEON
+    return "neon";
+#endif
+    return "scalar";
+}
+
+SystemState FSMBatch::getCurrentState(size_t i) const { return static_cast<SystemState>(states[i]); }
+int FSMBatch::getMoveCount(size_t i) const { return moveCounts[i]; }
+int FSMBatch::getErrorCount(size_t i) const { return errorCounts[i]; }
+uint32_t FSMBatch::getLastHeartbeat(size_t i) const { return lastHeartbeats[i]; }
+uint64_t FSMBatch::getTransitionCount(size_t i) const { return transitionCounts[i]; }
+
+const uint8_t *FSMBatch::stateData() const { return states.data(); }
+const int32_t *FSMBatch::moveCountData() const { return moveCounts.data(); }
+const int32_t *FSMBatch::errorCountData() const { return errorCounts.data(); }
+const uint32_t *FSMBatch::lastHeartbeatData() const { return lastHeartbeats.data(); }
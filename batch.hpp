@@ -0,0 +1,73 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "state.hpp"
+
+using namespace std;
+
+/**
+ * @brief Structure-of-arrays batch of robot machines stepped in one vectorized pass.
+ * Every field lives in its own contiguous array, step() advances all machines at once with AVX2
+ * (selected at runtime on x86), NEON on AArch64, or a scalar loop otherwise.
+ * Machine i after step(events, now) matches an FSM after dispatch(events[i]) with millis() returning now:
+ * same state, moveCount, errorCount, lastHeartbeat and transition count. The batch does not print
+ * and does not keep a history.
+ */
+class FSMBatch {
+
+        private:
+        vector<uint8_t> states;                 // SystemState of each machine
+        vector<int32_t> moveCounts;
+        vector<int32_t> errorCounts;
+        vector<uint32_t> lastHeartbeats;
+        vector<uint64_t> transitionCounts;
+        bool forceScalar;                       // Use the scalar loop even if SIMD is available
+
+        void stepScalar(const Event *events, uint32_t now, size_t begin, size_t end);
+
+        public:
+        /**
+         * @brief Create count machines in INIT with every counter at 0.
+         */
+        explicit FSMBatch(size_t count);
+
+        size_t size() const;
+
+        /**
+         * @brief Advance every machine by one step.
+         * @param events One event per machine, only read for the machines in IDLE.
+         * @param now Time in milliseconds used as heartbeat by the machines that transition.
+         */
+        void step(const Event *events, uint32_t now);
+
+        /**
+         * @brief Advance every machine by one step, events.size() must be size().
+         */
+        void step(const vector<Event> &events, uint32_t now);
+
+        /**
+         * @brief Use the scalar loop only, for comparisons with the vectorized pass.
+         */
+        void setForceScalar(bool scalar);
+
+        /**
+         * @brief Get the name of the backend step() uses: "avx2", "neon" or "scalar".
+         */
+        const char *backend() const;
+
+        SystemState getCurrentState(size_t i) const;
+        int getMoveCount(size_t i) const;
+        int getErrorCount(size_t i) const;
+        uint32_t getLastHeartbeat(size_t i) const;
+        uint64_t getTransitionCount(size_t i) const;
+
+        const uint8_t *stateData() const;
+        const int32_t *moveCountData() const;
+        const int32_t *errorCountData() const;
+        const uint32_t *lastHeartbeatData() const;
+};
+
+#endif // BATCH_H_
@@ -0,0 +1,591 @@
+#include "fsm.hpp"
+#include "static_fsm.hpp"
+#include "batch.hpp"
+#include "fleet.hpp"
+#include "watchdog.hpp"
+#include "hierarchy.hpp"
+#include "arena.hpp"
+#include "analytics.hpp"
+#include "command_server.hpp"
+#include "replication.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <streambuf>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Streambuf yang membuang semua output, agar benchmark tidak mengukur I/O terminal
+class NullBuffer : public streambuf {
+    protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char *, streamsize n) override { return n; }
+};
+
+static NullBuffer nullBuffer;
+static streambuf *realCout = nullptr;
+static const char *benchFilter = nullptr;
+
+static void muteCout() { realCout = cout.rdbuf(&nullBuffer); }
+static void unmuteCout() { cout.rdbuf(realCout); }
+
+// Jalankan op dalam sampel berisi batch op, lalu laporkan ns/op rata-rata, p50, p99
+static void bench(const string &name, size_t batch, size_t samples, const function<void()> &op) {
+    if (benchFilter && name.find(benchFilter) == string::npos) return;
+    vector<double> perOp;
+    perOp.reserve(samples);
+    muteCout();
+    for (size_t i = 0; i < batch; i++) op();
+    double total = 0;
+    for (size_t s = 0; s < samples; s++) {
+        auto t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < batch; i++) op();
+        auto t1 = chrono::steady_clock::now();
+        double ns = chrono::duration<double, nano>(t1 - t0).count() / batch;
+        perOp.push_back(ns);
+        total += ns;
+    }
+    unmuteCout();
+    sort(perOp.begin(), perOp.end());
+    double p50 = perOp[perOp.size() / 2];
+    double p99 = perOp[min(perOp.size() - 1, perOp.size() * 99 / 100)];
+    cout << left << setw(40) << name << right << fixed << setprecision(1)
+         << setw(12) << total / samples << " ns/op"
+         << setw(12) << p50 << " p50"
+         << setw(12) << p99 << " p99" << endl;
+}
+
+static void benchTransitions() {
+    FSM unbounded(0);
+    bench("transitionToState/unbounded", 256, 2000, [&] { unbounded.transitionToState(SystemState::IDLE); });
+    FSM ring(0, 1024);
+    bench("transitionToState/ring1024", 256, 2000, [&] { ring.transitionToState(SystemState::IDLE); });
+    FSM compact(0);
+    compact.setHistoryMode(HistoryMode::COMPACT);
+    bench("transitionToState/compact", 256, 2000, [&] { compact.transitionToState(SystemState::IDLE); });
+}
+
+// Tiap op: pindah ke state lalu satu langkah, baris transitionToState/ring1024 adalah biaya reset-nya
+static void benchDispatch() {
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        SystemState state = static_cast<SystemState>(s);
+        string suffix = STATE_NAMES[s];
+
+        EventQueue queue;
+        FSM sw(0, 1024);
+        sw.setEventQueue(&queue);
+        sw.setLogSink(&NullSink::instance());
+        bench("update/switch/" + suffix, 64, 1000, [&] {
+            sw.setErrorCount(0);
+            sw.transitionToState(state);
+            queue.push(Event::MOVE);
+            sw.update();
+            Event drop;
+            while (queue.pop(drop)) {}
+        });
+
+        FSM table(0, 1024);
+        table.setTransitionTable(&TransitionTable::defaultTable());
+        table.setLogSink(&NullSink::instance());
+        Event event = state == SystemState::IDLE ? Event::MOVE : Event::TICK;
+        bench("update/table/" + suffix, 64, 1000, [&] {
+            table.setErrorCount(0);
+            table.transitionToState(state);
+            table.dispatch(event);
+        });
+
+        RobotStaticFSM fixed(0, 1024);
+        fixed.setLogSink(&NullSink::instance());
+        bench("update/static/" + suffix, 64, 1000, [&] {
+            fixed.setErrorCount(0);
+            fixed.transitionToState(state);
+            fixed.dispatch(event);
+        });
+    }
+}
+
+static void benchHistory() {
+    for (size_t n : {16, 256, 4096, 65536}) {
+        FSM f(0);
+        for (size_t i = 1; i < n; i++) f.transitionToState(SystemState::IDLE);
+        size_t batch = max<size_t>(1, 65536 / n);
+        bench("getStateHistory/" + to_string(n), batch, 200, [&] {
+            vector<pair<SystemState, uint32_t>> copy = f.getStateHistory();
+            if (copy.empty()) cout << "";
+        });
+        bench("historyView/" + to_string(n), batch, 200, [&] {
+            HistoryView view = f.historyView();
+            if (view.empty()) cout << "";
+        });
+        f.setLogSink(&NullSink::instance());
+        // History tanpa batas: tiap cetak memformat ulang semua entry
+        bench("printStateHistory/" + to_string(n), max<size_t>(1, batch / 16), 50, [&] { f.printStateHistory(); });
+    }
+    // Ring penuh: hanya entry baru yang diformat, sisanya dari cache HistoryRenderer
+    FSM ring(0, 1024);
+    ring.setLogSink(&NullSink::instance());
+    for (size_t i = 0; i < 2048; i++) ring.transitionToState(SystemState::IDLE);
+    bench("printStateHistory/ring1024", 64, 50, [&] {
+        ring.transitionToState(SystemState::IDLE);
+        ring.printStateHistory();
+    });
+}
+
+// Biaya printStatus() untuk tiap jenis sink, SyncSink menulis ke stream yang dibuang
+static void benchSinks() {
+    FSM f(0);
+    f.setLogSink(&NullSink::instance());
+    bench("printStatus/null", 256, 1000, [&] { f.printStatus(); });
+    ostream discard(&nullBuffer);
+    SyncSink sync(discard);
+    f.setLogSink(&sync);
+    bench("printStatus/sync", 256, 1000, [&] { f.printStatus(); });
+    {
+        AsyncSink async(discard, 1 << 16, 1);
+        f.setLogSink(&async);
+        bench("printStatus/async", 256, 1000, [&] { f.printStatus(); });
+        f.setLogSink(nullptr);
+    }
+}
+
+// Biaya satu pembacaan untuk tiap sumber clock
+static void benchClocks() {
+    volatile uint64_t sink = 0;
+    bench("clock/steady", 256, 1000, [&] { sink = SteadyClock::instance().nanos(); });
+    TscClock &tsc = TscClock::instance();
+    bench("clock/tsc", 256, 1000, [&] { sink = tsc.nanos(); });
+    CachedClock cached(SteadyClock::instance());
+    bench("clock/cached", 256, 1000, [&] { sink = cached.nanos(); });
+    VirtualClock simulated(1);
+    bench("clock/virtual", 256, 1000, [&] { simulated.tick(); sink = simulated.nanos(); });
+    (void)sink;
+}
+
+// Biaya instrumentasi: update IDLE dengan queue kosong, dengan dan tanpa handler timing, lalu snapshot dan export
+static void benchStats() {
+    EventQueue queue;
+    FSM plain(0, 1024);
+    plain.setEventQueue(&queue);
+    plain.setLogSink(&NullSink::instance());
+    plain.transitionToState(SystemState::IDLE);
+    bench("stats/update/untimed", 256, 1000, [&] { plain.update(); });
+    FSM timed(0, 1024);
+    timed.setEventQueue(&queue);
+    timed.setLogSink(&NullSink::instance());
+    timed.setHandlerTiming(true);
+    timed.transitionToState(SystemState::IDLE);
+    bench("stats/update/timed", 256, 1000, [&] { timed.update(); });
+    CachedClock cached(SteadyClock::instance());
+    timed.setClock(&cached);
+    bench("stats/update/timed-cached", 256, 1000, [&] { cached.tick(); timed.update(); });
+    timed.setClock(nullptr);
+    bench("stats/snapshot", 64, 1000, [&] {
+        FsmStatsSnapshot snap = timed.getStats().snapshot();
+        if (snap.entries[0] == 1) cout << "";
+    });
+    ostream discard(&nullBuffer);
+    bench("stats/exportPrometheus", 4, 200, [&] { timed.exportStats(discard); });
+}
+
+// Tabel hasil kompilasi hierarki dibanding tabel default, IDLE -> MOVEMENT -> IDLE
+static void benchHierarchy() {
+    const TransitionTable *tables[] = {&TransitionTable::defaultTable(), &HierarchicalTable::robotTable()};
+    const char *names[] = {"dispatch/flat", "dispatch/hierarchical"};
+    for (size_t i = 0; i < 2; i++) {
+        FSM f(0, 1024);
+        f.setTransitionTable(tables[i]);
+        f.setLogSink(&NullSink::instance());
+        f.transitionToState(SystemState::IDLE);
+        bench(names[i], 256, 1000, [&] {
+            f.setMoveCount(0);
+            f.dispatch(Event::MOVE);
+            f.dispatch(Event::TICK);
+        });
+    }
+}
+
+// Coroutine yang tidak pernah selesai, tiap update melanjutkannya satu kali
+static Task benchSpin(FSM &) {
+    while (true) co_await skipTicks(1);
+}
+
+// Coroutine yang langsung selesai, tiap update membuat dan membebaskan satu frame
+static Task benchInstant(FSM &) { co_return; }
+
+static void benchCoroutines() {
+    FSM spin(0);
+    spin.setLogSink(&NullSink::instance());
+    spin.setCoroutineHandler(SystemState::MOVEMENT, benchSpin);
+    spin.transitionToState(SystemState::MOVEMENT);
+    bench("coroutine/resume", 256, 1000, [&] { spin.update(); });
+    FSM instant(0);
+    instant.setLogSink(&NullSink::instance());
+    instant.setCoroutineHandler(SystemState::MOVEMENT, benchInstant);
+    instant.transitionToState(SystemState::MOVEMENT);
+    bench("coroutine/start", 256, 1000, [&] { instant.update(); });
+}
+
+// Satu sweep: buat 1000 FSM dengan history ring 64, jalankan 16 transisi, lalu hancurkan semuanya
+static void benchArena() {
+    const size_t machines = 1000;
+    bench("sweep1000/heap", 1, 100, [&] {
+        vector<unique_ptr<FSM>> sweep;
+        sweep.reserve(machines);
+        for (size_t i = 0; i < machines; i++) {
+            sweep.emplace_back(new FSM(0, 64));
+            for (size_t t = 0; t < 16; t++) sweep.back()->transitionToState(SystemState::IDLE);
+        }
+    });
+    FSMArena arena;
+    bench("sweep1000/arena", 1, 100, [&] {
+        for (size_t i = 0; i < machines; i++) {
+            FSM &f = arena.create(0, 64);
+            for (size_t t = 0; t < 16; t++) f.transitionToState(SystemState::IDLE);
+        }
+        arena.release();
+    });
+}
+
+// 256 event MOVE/CALC/SHOOT diselingi TICK: dispatch satu per satu dibanding applyEvents, per event
+static void benchApplyEvents() {
+    const Event cycle[] = {Event::MOVE, Event::CALC, Event::SHOOT};
+    vector<Event> events(256);
+    for (size_t i = 0; i < events.size(); i++) events[i] = i % 2 ? Event::TICK : cycle[(i / 2) % 3];
+    FSM single(0);
+    single.setLogSink(&NullSink::instance());
+    bench("events256/dispatch", 1, 1000, [&] {
+        single.setErrorCount(0);
+        for (Event e : events) single.dispatch(e);
+    });
+    FSM batched(0);
+    batched.setLogSink(&NullSink::instance());
+    bench("events256/applyEvents", 1, 1000, [&] {
+        batched.setErrorCount(0);
+        batched.applyEvents(events);
+    });
+}
+
+// Analitik 256 history berisi 4096 entry, satu thread dibanding semua core
+static void benchAnalytics() {
+    vector<vector<HistoryEntry>> histories(256);
+    for (size_t h = 0; h < histories.size(); h++) {
+        for (size_t i = 0; i < 4096; i++) histories[h].emplace_back(static_cast<SystemState>(1 + (i + h) % 4), i * 1000000);
+    }
+    AnalyticsOptions single;
+    single.threads = 1;
+    bench("analytics/histories256/1thread", 1, 20, [&] { analyzeHistories(histories, single); });
+    bench("analytics/histories256/allcores", 1, 20, [&] { analyzeHistories(histories); });
+}
+
+// Cold start 1000 FSM sampai siap di IDLE: konstruktor biasa + performInit() dibanding config, lalu di arena
+static void benchStartup() {
+    const size_t machines = 1000;
+    vector<unique_ptr<FSM>> started;
+    started.reserve(machines);
+    bench("startup1000/delay+init", 1, 100, [&] {
+        started.clear();
+        for (size_t i = 0; i < machines; i++) {
+            started.emplace_back(new FSM(0));
+            started.back()->setLogSink(&NullSink::instance());
+            started.back()->performInit();
+            for (size_t t = 0; t < 16; t++) started.back()->transitionToState(SystemState::IDLE);
+        }
+    });
+    const FsmConfig config = {0, 0, 32, SystemState::IDLE, HistoryMode::FULL, ClockChoice::STEADY, SinkChoice::NONE};
+    bench("startup1000/config", 1, 100, [&] {
+        started.clear();
+        for (size_t i = 0; i < machines; i++) {
+            started.emplace_back(new FSM(config));
+            for (size_t t = 0; t < 16; t++) started.back()->transitionToState(SystemState::IDLE);
+        }
+    });
+    started.clear();
+    FSMArena arena;
+    bench("startup1000/config/arena", 1, 100, [&] {
+        for (size_t i = 0; i < machines; i++) {
+            FSM &f = arena.create(config);
+            for (size_t t = 0; t < 16; t++) f.transitionToState(SystemState::IDLE);
+        }
+        arena.release();
+    });
+}
+
+// Biaya snapshot dengan history ring 1024 penuh: capture ke memori, lalu tulis ke file
+static void benchSnapshot() {
+    FSM f(0, 1024);
+    for (size_t i = 0; i < 2048; i++) f.transitionToState(SystemState::IDLE);
+    FsmSnapshot snapshot;
+    bench("snapshot/capture1024", 16, 500, [&] { f.capture(snapshot); });
+    FSM target(0, 1024);
+    bench("snapshot/restore1024", 16, 500, [&] { target.restore(snapshot); });
+    SnapshotFile file("/tmp/fsm_bench_snapshot");
+    bench("snapshot/write1024", 4, 200, [&] { file.write(snapshot); });
+    FSM small(0, 16);
+    small.capture(snapshot);
+    bench("snapshot/write16", 4, 200, [&] { file.write(snapshot); });
+}
+
+// Urutan field FSM sebelum field panas dikelompokkan: field yang dipakai siklus IDLE/MOVEMENT tersebar di
+// empat cache line, di antara history, stats dan snapshot. Ukuran total sama dengan FSM.
+struct alignas(64) SpreadLayout {
+    SystemState currentState;
+    uint32_t lastHeartbeat;
+    uint32_t delay;
+    int errorCount;
+    char histories[sizeof(StateHistory) + sizeof(CompactHistory) + sizeof(HistoryMode)];
+    const TransitionTable *transitionTable;
+    EventQueue *eventQueue;
+    bool promptShown;
+    uint64_t transitionCount;
+    LogSink *sink;
+    Journal *journal;
+    StateBroadcast *broadcast;
+    ClockSource *clock;
+    char cold[sizeof(FSM) - 64 - sizeof(histories) - 72];
+    int moveCount;
+};
+
+// Urutan field FSM sekarang: semua field panas di cache line pertama
+struct alignas(64) PackedLayout {
+    SystemState currentState;
+    uint8_t hooks;
+    bool promptShown;
+    int moveCount;
+    int errorCount;
+    uint32_t lastHeartbeat;
+    uint64_t transitionCount;
+    ClockSource *clock;
+    LogSink *sink;
+    EventQueue *eventQueue;
+    const TransitionTable *transitionTable;
+    char cold[sizeof(FSM) - 64];
+};
+
+// Akses field yang sama dengan satu siklus IDLE -> MOVEMENT -> IDLE tanpa fitur opsional
+template <typename Layout>
+static void layoutCycle(Layout &m, uint32_t now) {
+    if (m.currentState == SystemState::IDLE && m.eventQueue && !m.transitionTable && m.clock) {
+        m.promptShown = false;
+        m.currentState = SystemState::MOVEMENT;
+        m.transitionCount++;
+        m.lastHeartbeat = now;
+    }
+    if (m.currentState == SystemState::MOVEMENT && m.sink) {
+        m.moveCount++;
+        m.currentState = m.moveCount >= 3 ? SystemState::SHOOTING : SystemState::IDLE;
+        m.transitionCount++;
+        m.lastHeartbeat = now + static_cast<uint32_t>(m.errorCount);
+    }
+    m.moveCount = 0;
+}
+
+template <typename Layout>
+static void benchLayout(const string &name, const vector<uint32_t> &order) {
+    vector<Layout> machines(order.size());
+    for (Layout &m : machines) {
+        memset(static_cast<void *>(&m), 0, sizeof(m));
+        m.currentState = SystemState::IDLE;
+        m.eventQueue = reinterpret_cast<EventQueue *>(&m);
+        m.clock = &SteadyClock::instance();
+        m.sink = &NullSink::instance();
+    }
+    uint32_t now = 0;
+    bench(name, 1, 200, [&] {
+        now++;
+        for (uint32_t i : order) layoutCycle(machines[i], now);
+    });
+}
+
+// Siklus panas IDLE -> MOVEMENT -> IDLE lewat event queue, satu FSM dan fleet 4096 FSM (cache dingin)
+static void benchHotPath() {
+    EventQueue queue;
+    FSM single(0, 1024);
+    single.setLogSink(&NullSink::instance());
+    single.setEventQueue(&queue);
+    single.transitionToState(SystemState::IDLE);
+    auto cycle = [](FSM &f, EventQueue &q) {
+        q.push(Event::MOVE);
+        f.update();
+        f.update();
+        f.setMoveCount(0);
+    };
+    bench("hotpath/cycle", 256, 2000, [&] { cycle(single, queue); });
+    const size_t machines = 4096;
+    vector<unique_ptr<EventQueue>> queues;
+    vector<unique_ptr<FSM>> fleet;
+    for (size_t i = 0; i < machines; i++) {
+        queues.emplace_back(new EventQueue());
+        fleet.emplace_back(new FSM(0, 64));
+        fleet.back()->setLogSink(&NullSink::instance());
+        fleet.back()->setEventQueue(queues.back().get());
+        fleet.back()->transitionToState(SystemState::IDLE);
+    }
+    bench("hotpath/cycle4096", 1, 200, [&] {
+        for (size_t i = 0; i < machines; i++) cycle(*fleet[i], *queues[i]);
+    });
+    // Field layout saja, 4096 FSM dalam urutan acak supaya prefetcher tidak menutupi miss
+    vector<uint32_t> order(machines);
+    for (size_t i = 0; i < machines; i++) order[i] = static_cast<uint32_t>(i);
+    shuffle(order.begin(), order.end(), mt19937(1));
+    benchLayout<SpreadLayout>("hotpath/layout4096/spread", order);
+    benchLayout<PackedLayout>("hotpath/layout4096/packed", order);
+}
+
+// Biaya notifikasi state change: publish saja, transisi dengan dan tanpa ring, dan poll subscriber
+static void benchBroadcast() {
+    StateBroadcast ring(1024);
+    bench("broadcast/publish", 256, 2000, [&] { ring.publish(SystemState::IDLE, SystemState::MOVEMENT, 0); });
+    FSM plain(0, 1024);
+    bench("broadcast/transition/none", 256, 2000, [&] { plain.transitionToState(SystemState::IDLE); });
+    FSM published(0, 1024);
+    published.setBroadcast(&ring);
+    bench("broadcast/transition/ring", 256, 2000, [&] { published.transitionToState(SystemState::IDLE); });
+    StateSubscription subscription(ring);
+    StateChange change;
+    bench("broadcast/publish+poll", 256, 2000, [&] {
+        ring.publish(SystemState::IDLE, SystemState::MOVEMENT, 0);
+        subscription.poll(change);
+    });
+}
+
+// Biaya membaca state dari thread lain lewat seqlock dibanding getter biasa
+static void benchObservation() {
+    FSM f(0);
+    volatile int sink = 0;
+    bench("observe/getters", 256, 1000, [&] { sink = f.getMoveCount() + f.getErrorCount() + static_cast<int>(f.getLastHeartbeat()); });
+    bench("observe/seqlock", 256, 1000, [&] {
+        Observation o = f.observe();
+        sink = o.moveCount + o.errorCount + static_cast<int>(o.heartbeat);
+    });
+    bench("observe/publish", 256, 1000, [&] { f.setMoveCount(1); });
+    (void)sink;
+}
+
+// Satu tick watchdog dengan 4096 FSM yang heartbeat-nya selalu baru
+static void benchWatchdog() {
+    ManualClock clock(0);
+    vector<unique_ptr<FSM>> machines;
+    Watchdog watchdog(100, 1, 512, clock);
+    for (size_t i = 0; i < 4096; i++) {
+        machines.emplace_back(new FSM(0));
+        machines.back()->setClock(&clock);
+        machines.back()->transitionToState(SystemState::MOVEMENT);
+        watchdog.watch(*machines.back());
+    }
+    size_t next = 0;
+    bench("Watchdog/tick4096", 64, 1000, [&] {
+        clock.advanceMillis(1);
+        for (size_t i = 0; i < 64; i++, next++) machines[next % machines.size()]->setLastHeartbeat(clock.millis());
+        watchdog.tick();
+    });
+}
+
+static void benchBatch() {
+    const size_t machines = 4096;
+    vector<Event> events(machines);
+    for (size_t i = 0; i < machines; i++) events[i] = static_cast<Event>(2 + i % 3);
+    FSMBatch simd(machines);
+    bench(string("FSMBatch/step4096/") + simd.backend(), 8, 500, [&] { simd.step(events, 0); });
+    FSMBatch scalar(machines);
+    scalar.setForceScalar(true);
+    bench("FSMBatch/step4096/scalar", 8, 500, [&] { scalar.step(events, 0); });
+}
+
+static void benchFleet() {
+    FleetRunner fleet;
+    for (size_t i = 0; i < 1024; i++) fleet.add(0, 64);
+    bench("FleetRunner/step1024", 4, 500, [&] {
+        for (size_t i = 0; i < fleet.size(); i++) fleet.queue(i).push(Event::MOVE);
+        fleet.step();
+    });
+}
+
+// 256 frame untuk 64 FSM lewat satu koneksi loopback: send, poll sampai semua ter-decode, lalu kosongkan queue
+static void benchCommandServer() {
+    FleetRunner fleet;
+    for (size_t i = 0; i < 64; i++) fleet.add(0, 64);
+    CommandServer server;
+    if (!server.listen(0, "127.0.0.1")) return;
+    server.routeFleet(fleet);
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(server.getPort());
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) return;
+    while (server.getStats().accepted == 0) server.poll(10);
+    uint8_t frames[256 * COMMAND_FRAME_SIZE];
+    for (size_t i = 0; i < 256; i++) encodeCommandFrame(frames + i * COMMAND_FRAME_SIZE, 2 + i % 3, static_cast<uint16_t>(i % 64));
+    bench("CommandServer/loopback256", 1, 2000, [&] {
+        send(client, frames, sizeof(frames), 0);
+        for (size_t got = 0; got < 256;) got += server.poll(10);
+        Event e;
+        for (size_t i = 0; i < fleet.size(); i++) while (fleet.queue(i).pop(e)) {}
+    });
+    close(client);
+}
+
+// Replikasi 4096 FSM lewat UDP loopback: tick tanpa perubahan, 1% FSM berubah per tick, dan apply satu datagram penuh
+static void benchReplication() {
+    vector<unique_ptr<FSM>> machines;
+    ReplicationPublisher publisher(1, 0);
+    ReplicaMirror mirror;
+    if (!mirror.listen(47100, nullptr, "127.0.0.1") || !publisher.connect("127.0.0.1", 47100)) return;
+    for (size_t i = 0; i < 4096; i++) {
+        machines.emplace_back(new FSM(0, 16));
+        publisher.track(*machines.back());
+    }
+    publisher.tick(0);
+    mirror.poll(10);
+    bench("replication/tick4096/idle", 1, 500, [&] { publisher.tick(0); });
+    size_t next = 0;
+    bench("replication/tick4096/1pct", 1, 500, [&] {
+        for (size_t i = 0; i < 41; i++, next += 97) machines[next % machines.size()]->transitionToState(SystemState::IDLE);
+        publisher.tick(0);
+        mirror.poll(0);
+    });
+    uint8_t datagram[REPLICATION_HEADER_BYTES + REPLICATION_DELTAS_PER_DATAGRAM * REPLICATION_DELTA_BYTES] = {};
+    ReplicationHeader header = {{'F', 'S', 'M', 'R'}, 2, 2, 0, 7, static_cast<uint32_t>(REPLICATION_DELTAS_PER_DATAGRAM), 0, 0};
+    for (size_t i = 0; i < REPLICATION_DELTAS_PER_DATAGRAM; i++) {
+        ReplicationDelta d = {static_cast<uint32_t>(i), 0, 0, 0, 1, 0, static_cast<uint8_t>(i % 4), {}};
+        encodeReplicationDelta(datagram + REPLICATION_HEADER_BYTES + i * REPLICATION_DELTA_BYTES, d);
+    }
+    bench("replication/apply" + to_string(REPLICATION_DELTAS_PER_DATAGRAM), 64, 1000, [&] {
+        header.sequence++;
+        encodeReplicationHeader(datagram, header);
+        mirror.apply(datagram, sizeof(datagram));
+    });
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) benchFilter = argv[1];
+    benchTransitions();
+    benchDispatch();
+    benchHistory();
+    benchSinks();
+    benchClocks();
+    benchStats();
+    benchHierarchy();
+    benchCoroutines();
+    benchArena();
+    benchStartup();
+    benchSnapshot();
+    benchApplyEvents();
+    benchAnalytics();
+    benchHotPath();
+    benchBroadcast();
+    benchObservation();
+    benchWatchdog();
+    benchBatch();
+    benchFleet();
+    benchCommandServer();
+    benchReplication();
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "clock.hpp"
+#include <chrono>
+#include <thread>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#define CLOCK_HAS_TSC 1
+#endif
+
+using namespace std;
+
+uint64_t SteadyClock::nanos() {
+    static auto start_time = chrono::steady_clock::now();
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start_time).count());
+}
+
+SteadyClock &SteadyClock::instance() {
+    static SteadyClock clock;
+    return clock;
+}
+
+ManualClock::ManualClock(uint64_t startNanos) : now(startNanos) {}
+uint64_t ManualClock::nanos() { return now; }
+void ManualClock::setMillis(uint32_t ms) { now = static_cast<uint64_t>(ms) * 1000000; }
+void ManualClock::setNanos(uint64_t ns) { now = ns; }
+void ManualClock::advanceMillis(uint32_t ms) { now += static_cast<uint64_t>(ms) * 1000000; }
+
+TscClock::TscClock(uint32_t calibrationMs) : base(0), mult(0), shift(0) {
+#if CLOCK_HAS_TSC
+    // Ukur frekuensi TSC sekali terhadap steady_clock
+    auto t0 = chrono::steady_clock::now();
+    uint64_t c0 = __rdtsc();
+    this_thread::sleep_for(chrono::milliseconds(calibrationMs));
+    auto t1 = chrono::steady_clock::now();
+    uint64_t c1 = __rdtsc();
+    double ns = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+    double nsPerTick = ns / static_cast<double>(c1 - c0);
+    shift = 24;
+    mult = static_cast<uint64_t>(nsPerTick * static_cast<double>(1ULL << shift));
+    // Origin disamakan dengan SteadyClock agar kedua clock bisa dibandingkan
+    base = c1 - static_cast<uint64_t>(static_cast<double>(SteadyClock::instance().nanos()) / nsPerTick);
+#else
+    (void)calibrationMs;
+#endif
+}
+
+uint64_t TscClock::nanos() {
+#if CLOCK_HAS_TSC
+    uint64_t delta = __rdtsc() - base;
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(delta) * mult) >> shift);
+#else
+    return SteadyClock::instance().nanos();
+#endif
+}
+
+double TscClock::getFrequency() const {
+    return mult ? static_cast<double>(1ULL << shift) / static_cast<double>(mult) * 1e9 : 0.0;
+}
+
+TscClock &TscClock::instance() {
+    static TscClock clock;
+    return clock;
+}
+
+CachedClock::CachedClock(ClockSource &s) : source(s), cached(s.nanos()) {}
+uint64_t CachedClock::nanos() { return cached.load(memory_order_relaxed); }
+void CachedClock::tick() { cached.store(source.nanos(), memory_order_relaxed); }
+
+VirtualClock::VirtualClock(uint32_t stepMs, uint64_t startNanos) : ManualClock(startNanos), step(static_cast<uint64_t>(stepMs) * 1000000) {}
+void VirtualClock::tick() { setNanos(nanos() + step); }
+void VirtualClock::setStep(uint32_t stepMs) { step = static_cast<uint64_t>(stepMs) * 1000000; }
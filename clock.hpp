@@ -0,0 +1,131 @@
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Time source of an FSM, used for heartbeats and history timestamps.
+ */
+class ClockSource {
+        public:
+        virtual ~ClockSource() {}
+
+        /**
+         * @brief Get the current time in nanoseconds since the origin of the clock.
+         */
+        virtual uint64_t nanos() = 0;
+
+        /**
+         * @brief Get the current time in milliseconds, truncated to 32 bits like millis().
+         */
+        uint32_t millis() { return static_cast<uint32_t>(nanos() / 1000000); }
+
+        /**
+         * @brief Called once per tick of whatever drives the FSMs (FSM::start(), FSM::run(), FleetRunner::step()),
+         * clocks that cache or simulate time advance here.
+         */
+        virtual void tick() {}
+};
+
+/**
+ * @brief steady_clock measured from the first call in the process, the clock behind the global millis().
+ */
+class SteadyClock : public ClockSource {
+        public:
+        uint64_t nanos() override;
+
+        /**
+         * @brief Get the shared steady clock, the default clock of every FSM.
+         */
+        static SteadyClock &instance();
+};
+
+/**
+ * @brief Clock that only moves when told to, for deterministic replay and tests.
+ */
+class ManualClock : public ClockSource {
+
+        private:
+        uint64_t now;                   // Current time in nanoseconds
+
+        public:
+        explicit ManualClock(uint64_t startNanos = 0);
+        uint64_t nanos() override;
+
+        void setMillis(uint32_t ms);
+        void setNanos(uint64_t ns);
+        void advanceMillis(uint32_t ms);
+};
+
+/**
+ * @brief Clock reading the CPU timestamp counter (rdtsc), calibrated once against steady_clock at construction.
+ * Much cheaper than steady_clock::now(), assumes an invariant TSC. Falls back to steady_clock on other architectures.
+ */
+class TscClock : public ClockSource {
+
+        private:
+        uint64_t base;                  // Counter value at the origin
+        uint64_t mult;                  // Nanoseconds per tick, fixed point
+        uint32_t shift;
+
+        public:
+        /**
+         * @brief Calibrate the counter frequency.
+         * @param calibrationMs Time spent measuring the frequency.
+         */
+        explicit TscClock(uint32_t calibrationMs = 10);
+        uint64_t nanos() override;
+
+        /**
+         * @brief Get the measured counter frequency in ticks per second, 0 when running on steady_clock.
+         */
+        double getFrequency() const;
+
+        /**
+         * @brief Get the clock shared by the whole process, calibrated on first use.
+         */
+        static TscClock &instance();
+};
+
+/**
+ * @brief Coarse clock returning the time of the last tick() of another clock.
+ * Reading it costs one relaxed atomic load, the underlying clock is only read once per tick.
+ * @note Safe to share between the threads of a fleet.
+ */
+class CachedClock : public ClockSource {
+
+        private:
+        ClockSource &source;
+        atomic<uint64_t> cached;        // Time of the last refresh
+
+        public:
+        explicit CachedClock(ClockSource &source);
+        uint64_t nanos() override;
+
+        /**
+         * @brief Read the underlying clock again.
+         */
+        void tick() override;
+};
+
+/**
+ * @brief Simulation clock moving forward by a fixed step at every tick(), independent of the wall clock and of the number of FSMs sharing it.
+ */
+class VirtualClock : public ManualClock {
+
+        private:
+        uint64_t step;                  // Nanoseconds added by tick()
+
+        public:
+        /**
+         * @param stepMs Simulated time of one tick, usually the FSM delay.
+         */
+        explicit VirtualClock(uint32_t stepMs, uint64_t startNanos = 0);
+        void tick() override;
+        void setStep(uint32_t stepMs);
+};
+
+#endif // CLOCK_H_
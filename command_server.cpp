@@ -0,0 +1,208 @@
+#include "command_server.hpp"
+#include "fleet.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const uint64_t LISTEN_TAG = UINT64_MAX;
+
+CommandServer::CommandServer()
+    : listenFd(-1), epollFd(-1), accepted(0), open(0), frames(0), dropped(0), unrouted(0), malformed(0), running(false) {}
+
+CommandServer::~CommandServer() {
+    stop();
+    for (uint32_t slot = 0; slot < connections.size(); slot++) {
+        if (connections[slot].fd >= 0) ::close(connections[slot].fd);
+    }
+    if (listenFd >= 0) ::close(listenFd);
+    if (epollFd >= 0) ::close(epollFd);
+}
+
+bool CommandServer::listen(uint16_t port, const char *address) {
+    listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) return false;
+    int yes = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address, &addr.sin_addr) != 1 || ::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0
+        || ::listen(listenFd, SOMAXCONN) < 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = LISTEN_TAG;
+    return epollFd >= 0 && ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) == 0;
+}
+
+uint16_t CommandServer::getPort() const {
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (listenFd < 0 || ::getsockname(listenFd, reinterpret_cast<sockaddr *>(&addr), &len) < 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+void CommandServer::route(uint16_t instance, EventQueue *queue) {
+    if (instance >= targets.size()) {
+        targets.resize(instance + 1, nullptr);
+        staging.resize(targets.size() * BATCH);
+        stagingCounts.resize(targets.size(), 0);
+    }
+    targets[instance] = queue;
+}
+
+void CommandServer::routeFleet(FleetRunner &fleet) {
+    for (size_t i = 0; i < fleet.size() && i <= UINT16_MAX; i++) route(static_cast<uint16_t>(i), &fleet.queue(i));
+}
+
+// Terima semua koneksi yang menunggu, edge-triggered jadi harus sampai EAGAIN
+void CommandServer::acceptAll() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        int yes = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        uint32_t slot;
+        if (!freeConnections.empty()) {
+            slot = freeConnections.back();
+            freeConnections.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(connections.size());
+            connections.push_back(Connection());
+        }
+        connections[slot].fd = fd;
+        connections[slot].partialLength = 0;
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLET | EPOLLRDHUP;
+        ev.data.u64 = slot;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            ::close(fd);
+            connections[slot].fd = -1;
+            freeConnections.push_back(slot);
+            continue;
+        }
+        bump(accepted);
+        bump(open);
+    }
+}
+
+void CommandServer::closeConnection(uint32_t slot, bool bad) {
+    Connection &c = connections[slot];
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+    ::close(c.fd);
+    c.fd = -1;
+    freeConnections.push_back(slot);
+    open.store(open.load(memory_order_relaxed) - 1, memory_order_relaxed);
+    if (bad) bump(malformed);
+}
+
+void CommandServer::stage(uint16_t instance, uint8_t command) {
+    EventQueue *queue = instance < targets.size() ? targets[instance] : nullptr;
+    if (!queue) {
+        bump(unrouted);
+        return;
+    }
+    uint16_t &count = stagingCounts[instance];
+    if (count == 0) touched.push_back(instance);
+    if (count == BATCH) {
+        bump(dropped, BATCH - queue->pushBatch(&staging[instance * BATCH], BATCH));
+        count = 0;
+    }
+    staging[instance * BATCH + count++] = commandToEvent(command);
+}
+
+// Kirim semua event yang dikumpulkan dalam satu read, satu pushBatch per target
+void CommandServer::flushStaged() {
+    for (uint16_t instance : touched) {
+        uint16_t &count = stagingCounts[instance];
+        if (count > 0) bump(dropped, count - targets[instance]->pushBatch(&staging[instance * BATCH], count));
+        count = 0;
+    }
+    touched.clear();
+}
+
+// Baca sampai EAGAIN, decode frame langsung dari buffer
+void CommandServer::readAll(uint32_t slot) {
+    Connection &c = connections[slot];
+    while (true) {
+        size_t carried = c.partialLength;
+        memcpy(readBuffer, c.partial, carried);
+        ssize_t n = ::read(c.fd, readBuffer + carried, READ_BYTES - carried);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            closeConnection(slot, false);
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        size_t available = carried + static_cast<size_t>(n);
+        size_t offset = 0;
+        uint64_t decoded = 0;
+        for (; offset + COMMAND_FRAME_SIZE <= available; offset += COMMAND_FRAME_SIZE) {
+            const uint8_t *frame = readBuffer + offset;
+            if (frame[0] != COMMAND_FRAME_MAGIC) {
+                bump(frames, decoded);
+                closeConnection(slot, true);
+                return;
+            }
+            stage(static_cast<uint16_t>(frame[2] | frame[3] << 8), frame[1]);
+            decoded++;
+        }
+        bump(frames, decoded);
+        c.partialLength = static_cast<uint8_t>(available - offset);
+        memcpy(c.partial, readBuffer + offset, c.partialLength);
+    }
+}
+
+size_t CommandServer::poll(int timeoutMs) {
+    if (epollFd < 0) return 0;
+    epoll_event events[64];
+    int n = ::epoll_wait(epollFd, events, 64, timeoutMs);
+    uint64_t before = frames.load(memory_order_relaxed);
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.u64 == LISTEN_TAG) {
+            acceptAll();
+            continue;
+        }
+        uint32_t slot = static_cast<uint32_t>(events[i].data.u64);
+        if (connections[slot].fd < 0) continue;
+        if (events[i].events & EPOLLIN) readAll(slot);
+        if (connections[slot].fd >= 0 && (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP))) {
+            if (events[i].events & EPOLLRDHUP) readAll(slot);
+            if (connections[slot].fd >= 0) closeConnection(slot, false);
+        }
+    }
+    flushStaged();
+    return static_cast<size_t>(frames.load(memory_order_relaxed) - before);
+}
+
+void CommandServer::start() {
+    if (running.exchange(true)) return;
+    worker = thread([this] {
+        while (running.load(memory_order_acquire)) poll(10);
+    });
+}
+
+void CommandServer::stop() {
+    if (!running.exchange(false)) return;
+    if (worker.joinable()) worker.join();
+}
+
+CommandServerStats CommandServer::getStats() const {
+    return {accepted.load(memory_order_relaxed), open.load(memory_order_relaxed), frames.load(memory_order_relaxed),
+            dropped.load(memory_order_relaxed), unrouted.load(memory_order_relaxed), malformed.load(memory_order_relaxed)};
+}
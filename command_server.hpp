@@ -0,0 +1,124 @@
+#ifndef COMMAND_SERVER_H_
+#define COMMAND_SERVER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "state.hpp"
+#include "event_queue.hpp"
+
+using namespace std;
+
+class FleetRunner;
+
+const uint8_t COMMAND_FRAME_MAGIC = 0xC5;
+const size_t COMMAND_FRAME_SIZE = 4;
+
+/**
+ * @brief Encode a command frame: magic, command (1-5 like the cin prompt), instance index (little endian).
+ */
+inline void encodeCommandFrame(uint8_t *out, int command, uint16_t instance) {
+        out[0] = COMMAND_FRAME_MAGIC;
+        out[1] = static_cast<uint8_t>(command);
+        out[2] = static_cast<uint8_t>(instance & 0xFF);
+        out[3] = static_cast<uint8_t>(instance >> 8);
+}
+
+struct CommandServerStats {
+        uint64_t accepted;              // Connections accepted
+        uint64_t open;                  // Connections currently open
+        uint64_t frames;                // Frames decoded
+        uint64_t dropped;               // Commands lost because the target queue was full
+        uint64_t unrouted;              // Commands for an instance without a queue
+        uint64_t malformed;             // Connections closed because of a bad magic byte
+};
+
+/**
+ * @brief Nonblocking TCP front end decoding binary command frames from many clients into event queues.
+ * One thread runs an edge-triggered epoll loop, reads each socket into a fixed buffer, decodes the 4-byte frames in place
+ * (a frame split across reads is carried in the connection), then pushes the commands of each read into their queue
+ * with one pushBatch(), so nothing is allocated per message.
+ * Instance 0 is the single FSM case, route() or routeFleet() fan the other instances out to a fleet.
+ * @note The server thread is the producer of every routed queue, nothing else may push into them.
+ */
+class CommandServer {
+
+        private:
+        static const size_t READ_BYTES = 64 * 1024;
+        static const size_t BATCH = 256;
+
+        struct Connection {
+                int fd;                                 // -1 for a free slot
+                uint8_t partial[COMMAND_FRAME_SIZE];    // Start of a frame split across reads
+                uint8_t partialLength;
+        };
+
+        int listenFd;
+        int epollFd;
+        vector<EventQueue *> targets;           // Queue of each instance
+        vector<Connection> connections;         // Indexed by the epoll user data
+        vector<uint32_t> freeConnections;
+        vector<Event> staging;                  // BATCH events per touched target
+        vector<uint16_t> stagingCounts;
+        vector<uint16_t> touched;               // Targets with staged events
+        uint8_t readBuffer[READ_BYTES];
+
+        atomic<uint64_t> accepted, open, frames, dropped, unrouted, malformed;
+        atomic<bool> running;
+        thread worker;
+
+        void acceptAll();
+        void readAll(uint32_t slot);
+        void closeConnection(uint32_t slot, bool bad);
+        void stage(uint16_t instance, uint8_t command);
+        void flushStaged();
+        static void bump(atomic<uint64_t> &counter, uint64_t by = 1) { counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed); }
+
+        public:
+        CommandServer();
+        ~CommandServer();
+        CommandServer(const CommandServer &) = delete;
+        CommandServer &operator=(const CommandServer &) = delete;
+
+        /**
+         * @brief Listen for clients.
+         * @param port TCP port, 0 for any free port, see getPort().
+         * @return false if the socket cannot be bound.
+         */
+        bool listen(uint16_t port, const char *address = "0.0.0.0");
+
+        /**
+         * @brief Get the port the server listens on.
+         */
+        uint16_t getPort() const;
+
+        /**
+         * @brief Deliver the commands addressed to instance into queue.
+         * @note The queue is not copied, it must outlive the server. Call before start().
+         */
+        void route(uint16_t instance, EventQueue *queue);
+
+        /**
+         * @brief Route instance i to the queue of FSM i of a fleet, for every FSM of the fleet.
+         */
+        void routeFleet(FleetRunner &fleet);
+
+        /**
+         * @brief Run one round of the event loop.
+         * @param timeoutMs Maximum wait for socket activity, 0 to only handle what is ready.
+         * @return The number of frames decoded.
+         */
+        size_t poll(int timeoutMs);
+
+        /**
+         * @brief Run poll() from a background thread until stop() or destruction.
+         */
+        void start();
+        void stop();
+
+        CommandServerStats getStats() const;
+};
+
+#endif // COMMAND_SERVER_H_
@@ -0,0 +1,48 @@
+#include "config.hpp"
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+static const char CONFIG_MAGIC[4] = {'F', 'S', 'M', 'C'};
+static const uint32_t CONFIG_VERSION = 1;
+
+void encodeConfig(const FsmConfig &config, FsmConfigBlob &blob) {
+    memset(&blob, 0, sizeof(blob));
+    memcpy(blob.magic, CONFIG_MAGIC, sizeof(CONFIG_MAGIC));
+    blob.version = CONFIG_VERSION;
+    blob.config = config;
+}
+
+bool decodeConfig(const void *data, size_t length, FsmConfig &config) {
+    FsmConfigBlob blob;
+    if (length != sizeof(blob)) return false;
+    memcpy(&blob, data, sizeof(blob));
+    if (memcmp(blob.magic, CONFIG_MAGIC, sizeof(CONFIG_MAGIC)) != 0 || blob.version != CONFIG_VERSION) return false;
+    const FsmConfig &c = blob.config;
+    if (static_cast<size_t>(c.initialState) >= STATE_COUNT || c.historyMode > HistoryMode::COMPACT
+        || c.clock > ClockChoice::TSC || c.sink > SinkChoice::NONE) {
+        return false;
+    }
+    config = c;
+    return true;
+}
+
+bool saveConfig(const string &path, const FsmConfig &config) {
+    FsmConfigBlob blob;
+    encodeConfig(config, blob);
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(&blob, sizeof(blob), 1, f) == 1;
+    return fclose(f) == 0 && ok;
+}
+
+bool loadConfig(const string &path, FsmConfig &config) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    // Satu byte lebih untuk mendeteksi file yang terlalu panjang
+    unsigned char data[sizeof(FsmConfigBlob) + 1];
+    size_t length = fread(data, 1, sizeof(data), f);
+    fclose(f);
+    return decodeConfig(data, length, config);
+}
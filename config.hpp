@@ -0,0 +1,69 @@
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "state.hpp"
+#include "history.hpp"
+
+using namespace std;
+
+enum class ClockChoice : uint8_t {
+        STEADY,         // SteadyClock::instance()
+        TSC             // TscClock::instance(), calibrated once per process
+};
+
+enum class SinkChoice : uint8_t {
+        STDOUT,         // SyncSink::standard()
+        NONE            // NullSink::instance(), no output at all
+};
+
+/**
+ * @brief Everything an FSM needs at construction, trivially copyable so it can be a constexpr or a binary blob.
+ * An FSM built from a config starts directly in initialState without printing anything, with its history
+ * storage allocated once up front; other clocks and sinks are set afterwards with setClock() and setLogSink().
+ */
+struct FsmConfig {
+        uint32_t delay;                 // Delay in milliseconds for each state transition
+        uint32_t historyCapacity;       // Ring buffer slots, 0 for the unbounded history
+        uint32_t historyReserve;        // Entries preallocated by the unbounded history
+        SystemState initialState;       // INIT keeps performInit() in start(), any other state skips it
+        HistoryMode historyMode;
+        ClockChoice clock;
+        SinkChoice sink;
+};
+
+/**
+ * @brief Config of the interactive robot of main.cpp: 2000 ms delay, ready in IDLE.
+ */
+constexpr FsmConfig ROBOT_CONFIG = {2000, 0, 256, SystemState::IDLE, HistoryMode::FULL, ClockChoice::STEADY, SinkChoice::STDOUT};
+
+/**
+ * @brief Binary form of a config as stored in a file.
+ */
+struct FsmConfigBlob {
+        char magic[4];                  // "FSMC"
+        uint32_t version;
+        FsmConfig config;
+};
+
+/**
+ * @brief Write config into blob.
+ */
+void encodeConfig(const FsmConfig &config, FsmConfigBlob &blob);
+
+/**
+ * @brief Read a config from the bytes of a blob.
+ * @return false if the magic, version, size or one of the enum values is wrong.
+ */
+bool decodeConfig(const void *data, size_t length, FsmConfig &config);
+
+/**
+ * @brief Save or load a config blob file.
+ * @return false on I/O error or, for loadConfig(), an invalid blob.
+ */
+bool saveConfig(const string &path, const FsmConfig &config);
+bool loadConfig(const string &path, FsmConfig &config);
+
+#endif // CONFIG_H_
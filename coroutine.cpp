@@ -0,0 +1,143 @@
+#include "coroutine.hpp"
+#include "fsm.hpp"
+#include <new>
+
+using namespace std;
+
+static const size_t CLASS_SIZES[] = {128, 256, 512, 1024};
+static const size_t FRAME_HEADER = 16;          // Pool pemilik frame, ukuran menjaga alignment 16 byte
+
+FramePool::FramePool(size_t blocks) : blocksPerChunk(blocks ? blocks : 1), allocations(0), heapAllocations(0) {
+    for (size_t i = 0; i < CLASS_COUNT; i++) freeLists[i] = nullptr;
+}
+
+FramePool::~FramePool() {
+    for (void *chunk : chunks) ::operator delete(chunk);
+}
+
+size_t FramePool::sizeClass(size_t bytes) {
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        if (bytes <= CLASS_SIZES[i]) return i;
+    }
+    return CLASS_COUNT;
+}
+
+// Ambil dari free list, isi ulang satu chunk jika kosong
+void *FramePool::allocate(size_t bytes) {
+    allocations++;
+    size_t c = sizeClass(bytes);
+    if (c == CLASS_COUNT) {
+        heapAllocations++;
+        return ::operator new(bytes);
+    }
+    if (!freeLists[c]) {
+        heapAllocations++;
+        char *chunk = static_cast<char *>(::operator new(CLASS_SIZES[c] * blocksPerChunk));
+        chunks.push_back(chunk);
+        for (size_t i = 0; i < blocksPerChunk; i++) {
+            FreeBlock *block = reinterpret_cast<FreeBlock *>(chunk + i * CLASS_SIZES[c]);
+            block->next = freeLists[c];
+            freeLists[c] = block;
+        }
+    }
+    FreeBlock *block = freeLists[c];
+    freeLists[c] = block->next;
+    return block;
+}
+
+void FramePool::deallocate(void *frame, size_t bytes) {
+    size_t c = sizeClass(bytes);
+    if (c == CLASS_COUNT) {
+        ::operator delete(frame);
+        return;
+    }
+    FreeBlock *block = static_cast<FreeBlock *>(frame);
+    block->next = freeLists[c];
+    freeLists[c] = block;
+}
+
+uint64_t FramePool::getAllocations() const { return allocations; }
+uint64_t FramePool::getHeapAllocations() const { return heapAllocations; }
+
+// Header di depan frame menyimpan pool asalnya, null untuk frame dari operator new
+void *Task::promise_type::operator new(size_t bytes, FSM &fsm) {
+    FramePool *pool = &fsm.getFramePool();
+    char *block = static_cast<char *>(pool->allocate(bytes + FRAME_HEADER));
+    *reinterpret_cast<FramePool **>(block) = pool;
+    return block + FRAME_HEADER;
+}
+
+void *Task::promise_type::operator new(size_t bytes) {
+    char *block = static_cast<char *>(::operator new(bytes + FRAME_HEADER));
+    *reinterpret_cast<FramePool **>(block) = nullptr;
+    return block + FRAME_HEADER;
+}
+
+void Task::promise_type::operator delete(void *frame, size_t bytes) {
+    char *block = static_cast<char *>(frame) - FRAME_HEADER;
+    FramePool *pool = *reinterpret_cast<FramePool **>(block);
+    if (pool) pool->deallocate(block, bytes + FRAME_HEADER);
+    else      ::operator delete(block);
+}
+
+Task &Task::operator=(Task &&other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy();
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+Task::~Task() {
+    if (handle) handle.destroy();
+}
+
+// Lanjutkan body jika kondisi tunggunya sudah terpenuhi
+bool Task::step(ClockSource &clock, EventQueue *queue) {
+    if (!handle || handle.done()) return true;
+    promise_type &p = handle.promise();
+    p.clock = &clock;
+    switch (p.wait) {
+        case Wait::NONE:   break;
+        case Wait::MILLIS: if (clock.nanos() / NANOS_PER_MILLI < p.until) return false; break;
+        case Wait::TICKS:  if (--p.until > 0) return false; break;
+        case Wait::EVENT:
+            if (queue && !queue->pop(p.event)) return false;
+            if (!queue) p.event = Event::TICK;
+            break;
+    }
+    p.wait = Wait::NONE;
+    handle.resume();
+    if (p.error) rethrow_exception(p.error);
+    return handle.done();
+}
+
+void TaskWait::await_suspend(coroutine_handle<Task::promise_type> h) noexcept {
+    promise = &h.promise();
+    promise->wait = wait;
+    promise->until = wait == Task::Wait::MILLIS ? promise->clock->nanos() / NANOS_PER_MILLI + amount : amount;
+}
+
+namespace robot_coroutines {
+
+Task movement(FSM &fsm) {
+    LogLine(fsm.getLogSink()) << "Moving...\n";
+    uint32_t delay;
+    fsm.getDelay(delay);
+    co_await sleepMillis(delay);
+    fsm.setMoveCount(fsm.getMoveCount() + 1);
+    fsm.transitionToState(fsm.getMoveCount() >= 3 ? SystemState::SHOOTING : SystemState::IDLE);
+}
+
+Task shooting(FSM &fsm) {
+    uint32_t delay;
+    fsm.getDelay(delay);
+    co_await sleepMillis(delay / 2);
+    LogLine(fsm.getLogSink()) << "Shooting...\n";
+    co_await sleepMillis(delay - delay / 2);
+    fsm.setMoveCount(0);
+    fsm.transitionToState(SystemState::IDLE);
+}
+
+} // namespace robot_coroutines
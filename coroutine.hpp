@@ -0,0 +1,164 @@
+#ifndef COROUTINE_H_
+#define COROUTINE_H_
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+#include "state.hpp"
+#include "clock.hpp"
+#include "event_queue.hpp"
+
+using namespace std;
+
+class FSM;
+
+/**
+ * @brief Free-list allocator of coroutine frames, one per FSM.
+ * Frames are rounded up to a size class (128, 256, 512 or 1024 bytes) and come from chunks of blocksPerChunk blocks,
+ * a freed frame goes back to its list, so starting a handler every tick does not touch the heap.
+ * Larger frames fall back to operator new.
+ * @note Not thread-safe: the pool belongs to its FSM and is only used by whichever thread is updating that FSM,
+ * so an FSM may move between the threads of a FleetRunner. Each frame starts with a header naming its pool,
+ * Task frees it there whatever thread destroys it.
+ */
+class FramePool {
+
+        private:
+        static const size_t CLASS_COUNT = 4;
+
+        struct FreeBlock {
+                FreeBlock *next;
+        };
+
+        FreeBlock *freeLists[CLASS_COUNT];
+        size_t blocksPerChunk;                  // Blocks taken from operator new when a list is empty
+        vector<void *> chunks;                  // Memory owned by the pool, released on destruction
+        uint64_t allocations;                   // Frames allocated
+        uint64_t heapAllocations;               // Chunks and oversized frames taken from operator new
+
+        static size_t sizeClass(size_t bytes);
+
+        public:
+        /**
+         * @param blocksPerChunk Blocks allocated at once per size class, 1 suits an FSM running one handler at a time.
+         */
+        explicit FramePool(size_t blocksPerChunk = 1);
+        ~FramePool();
+        FramePool(const FramePool &) = delete;
+        FramePool &operator=(const FramePool &) = delete;
+
+        void *allocate(size_t bytes);
+        void deallocate(void *frame, size_t bytes);
+
+        uint64_t getAllocations() const;
+        uint64_t getHeapAllocations() const;
+};
+
+/**
+ * @brief Coroutine state handler, started when the FSM enters its state and resumed by later update() calls.
+ * The body calls fsm.transitionToState() when it is done, like a perform*() handler, and may suspend on
+ * sleepMillis(), skipTicks() or nextEvent() in between. Returning without a transition restarts it on the next update().
+ */
+class Task {
+
+        public:
+        enum class Wait : uint8_t {NONE, MILLIS, TICKS, EVENT};
+
+        struct promise_type {
+                Wait wait;                      // What the suspended body waits for
+                uint64_t until;                 // Clock time in milliseconds for MILLIS, remaining updates for TICKS
+                Event event;                    // Event popped for EVENT
+                ClockSource *clock;             // Clock of the FSM running the task
+                exception_ptr error;            // Exception escaping the body, rethrown by step()
+
+                promise_type() : wait(Wait::NONE), until(0), event(Event::TICK), clock(nullptr) {}
+                Task get_return_object() { return Task(coroutine_handle<promise_type>::from_promise(*this)); }
+                suspend_always initial_suspend() noexcept { return {}; }
+                suspend_always final_suspend() noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { error = current_exception(); }
+
+                // Handler taking the FSM: frame from FSM::getFramePool(), other coroutines use operator new
+                static void *operator new(size_t bytes, FSM &fsm);
+                static void *operator new(size_t bytes);
+                static void operator delete(void *frame, size_t bytes);
+        };
+
+        private:
+        coroutine_handle<promise_type> handle;
+
+        explicit Task(coroutine_handle<promise_type> h) : handle(h) {}
+
+        public:
+        Task() : handle(nullptr) {}
+        Task(Task &&other) noexcept : handle(other.handle) { other.handle = nullptr; }
+        Task &operator=(Task &&other) noexcept;
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+        ~Task();
+
+        /**
+         * @brief Resume the body if what it waits for happened.
+         * @param clock Clock of the FSM, used for sleepMillis().
+         * @param queue Event source of nextEvent(), null to resume it with Event::TICK on every update.
+         * @return true once the body has finished.
+         */
+        bool step(ClockSource &clock, EventQueue *queue);
+
+        /**
+         * @brief Check if the task holds a coroutine, finished or not.
+         */
+        explicit operator bool() const { return handle != nullptr; }
+};
+
+/**
+ * @brief Awaiter suspending a Task until a condition checked by step().
+ */
+struct TaskWait {
+        Task::Wait wait;
+        uint64_t amount;
+        Task::promise_type *promise;
+
+        bool await_ready() const noexcept { return amount == 0 && wait != Task::Wait::EVENT; }
+        void await_suspend(coroutine_handle<Task::promise_type> h) noexcept;
+        Event await_resume() const noexcept { return promise ? promise->event : Event::TICK; }
+};
+
+/**
+ * @brief Suspend for at least ms milliseconds of the FSM clock.
+ */
+inline TaskWait sleepMillis(uint32_t ms) { return {Task::Wait::MILLIS, ms, nullptr}; }
+
+/**
+ * @brief Suspend for n update() calls.
+ */
+inline TaskWait skipTicks(uint32_t n) { return {Task::Wait::TICKS, n, nullptr}; }
+
+/**
+ * @brief Suspend until the FSM event queue has an event, co_await returns it.
+ */
+inline TaskWait nextEvent() { return {Task::Wait::EVENT, 0, nullptr}; }
+
+/**
+ * @brief State handler written as a coroutine, see FSM::setCoroutineHandler().
+ */
+typedef Task (*CoroutineHandler)(FSM &fsm);
+
+/**
+ * @brief Multi-step versions of the robot handlers, each step taking real time instead of completing instantly.
+ */
+namespace robot_coroutines {
+        /**
+         * @brief Print "Moving..." then wait the FSM delay before counting the move, same transitions as performMovement().
+         */
+        Task movement(FSM &fsm);
+
+        /**
+         * @brief Aim for half the FSM delay, print "Shooting...", recoil for the other half, same transitions as performShooting().
+         */
+        Task shooting(FSM &fsm);
+}
+
+#endif // COROUTINE_H_
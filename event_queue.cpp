@@ -0,0 +1,81 @@
+#include "event_queue.hpp"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace std;
+
+StdinReader::StdinReader(EventQueue &q, int inputFd) : queue(q), fd(inputFd), finished(false), stopped(false) {
+    // Tanpa pipe thread tidak bisa dibangunkan, jangan dijalankan
+    if (::pipe(wake) != 0) {
+        wake[0] = wake[1] = -1;
+        finished.store(true);
+        return;
+    }
+    worker = thread(&StdinReader::run, this);
+}
+
+StdinReader::~StdinReader() {
+    stopped.store(true);
+    if (worker.joinable()) {
+        char byte = 0;
+        while (::write(wake[1], &byte, 1) < 0 && errno == EINTR) {}
+        worker.join();
+    }
+    if (wake[0] >= 0) ::close(wake[0]);
+    if (wake[1] >= 0) ::close(wake[1]);
+}
+
+// Token jadi command, selain angka dalam jangkauan int (atau token terlalu panjang) dianggap command 0
+static int parseCommand(char *token, size_t length) {
+    token[length] = '\0';
+    char *end;
+    long cmd = strtol(token, &end, 10);
+    return *end == '\0' && cmd >= INT_MIN && cmd <= INT_MAX ? static_cast<int>(cmd) : 0;
+}
+
+// Kirim satu command, tunggu jika queue penuh kecuali sedang dihentikan
+void StdinReader::post(int cmd) {
+    Event event = commandToEvent(cmd);
+    while (!stopped.load(memory_order_relaxed) && !queue.push(event)) this_thread::yield();
+}
+
+// Baca token dari fd lalu kirim ke queue, sampai EOF atau dibangunkan destruktor
+void StdinReader::run() {
+    pollfd fds[2] = {{fd, POLLIN, 0}, {wake[0], POLLIN, 0}};
+    char buffer[256];
+    char token[32];
+    size_t length = 0;
+    while (!stopped.load(memory_order_relaxed)) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!fds[0].revents) continue;
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; i++) {
+            char c = buffer[i];
+            bool space = c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+            if (!space) {
+                if (length < sizeof(token) - 1) token[length] = c;
+                length++;
+                continue;
+            }
+            if (length == 0) continue;
+            post(length < sizeof(token) ? parseCommand(token, length) : 0);
+            length = 0;
+        }
+    }
+    // Token terakhir tanpa spasi penutup, seperti cin >> cmd di EOF
+    if (length > 0 && !stopped.load(memory_order_relaxed)) {
+        post(length < sizeof(token) ? parseCommand(token, length) : 0);
+    }
+    finished.store(true, memory_order_release);
+}
+
+bool StdinReader::isFinished() const { return finished.load(memory_order_acquire); }
@@ -0,0 +1,113 @@
+#ifndef EVENT_QUEUE_H_
+#define EVENT_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include "state.hpp"
+
+using namespace std;
+
+/**
+ * @brief Bounded lock-free single-producer single-consumer queue.
+ * One thread may push while another pops, neither ever blocks.
+ * @note N must be a power of two. With several producers, give each one its own queue.
+ */
+template <class T, size_t N>
+class SpscQueue {
+
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+        private:
+        alignas(64) atomic<size_t> head;        // Next slot to pop, written by the consumer
+        alignas(64) atomic<size_t> tail;        // Next slot to push, written by the producer
+        T buffer[N];
+
+        public:
+        SpscQueue() : head(0), tail(0) {}
+
+        /**
+         * @brief Push an item, producer side.
+         * @return false if the queue is full.
+         */
+        bool push(const T &item) {
+                size_t t = tail.load(memory_order_relaxed);
+                if (t - head.load(memory_order_acquire) == N) return false;
+                buffer[t & (N - 1)] = item;
+                tail.store(t + 1, memory_order_release);
+                return true;
+        }
+
+        /**
+         * @brief Push up to count items with a single release, producer side.
+         * @return The number of items pushed, less than count if the queue filled up.
+         */
+        size_t pushBatch(const T *items, size_t count) {
+                size_t t = tail.load(memory_order_relaxed);
+                size_t space = N - (t - head.load(memory_order_acquire));
+                size_t n = count < space ? count : space;
+                for (size_t i = 0; i < n; i++) buffer[(t + i) & (N - 1)] = items[i];
+                tail.store(t + n, memory_order_release);
+                return n;
+        }
+
+        /**
+         * @brief Pop an item, consumer side.
+         * @return false if the queue is empty.
+         */
+        bool pop(T &item) {
+                size_t h = head.load(memory_order_relaxed);
+                if (h == tail.load(memory_order_acquire)) return false;
+                item = buffer[h & (N - 1)];
+                head.store(h + 1, memory_order_release);
+                return true;
+        }
+
+        /**
+         * @brief Check if the queue is empty, exact only on the consumer side.
+         */
+        bool empty() const {
+                return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+        }
+
+        static constexpr size_t capacity() { return N; }
+};
+
+typedef SpscQueue<Event, 1024> EventQueue;
+
+/**
+ * @brief Background thread reading commands from a file descriptor (stdin by default) and posting them into an EventQueue.
+ * Commands are whitespace separated integers like cin >> cmd, a token that is not a number posts command 0 (INVALID).
+ * The thread waits with poll() on the descriptor and on a wake-up pipe, so the destructor always stops and joins it,
+ * even while no input arrives; once destroyed the queue is never touched again.
+ * @note The thread ends on EOF. It reads the descriptor directly, do not read cin at the same time.
+ */
+class StdinReader {
+
+        private:
+        EventQueue &queue;              // Queue receiving the commands
+        int fd;                         // Descriptor read
+        int wake[2];                    // Pipe written by the destructor to interrupt poll()
+        atomic<bool> finished;          // Set once the descriptor reached EOF or failed
+        atomic<bool> stopped;           // Set by the destructor
+        thread worker;
+
+        void run();
+        void post(int cmd);
+
+        public:
+        /**
+         * @param fd Descriptor to read, 0 for stdin.
+         */
+        explicit StdinReader(EventQueue &queue, int fd = 0);
+        ~StdinReader();
+        StdinReader(const StdinReader &) = delete;
+        StdinReader &operator=(const StdinReader &) = delete;
+
+        /**
+         * @brief Check if the descriptor reached EOF and every command read was posted.
+         */
+        bool isFinished() const;
+};
+
+#endif // EVENT_QUEUE_H_
@@ -0,0 +1,144 @@
+#include "fleet.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+FleetRunner::FleetRunner(size_t threads, size_t chunkSize)
+    : workerCount(threads ? threads : max<size_t>(1, thread::hardware_concurrency())),
+      chunk(max<size_t>(1, chunkSize)), clock(&SteadyClock::instance()), generation(0), running(0), stopping(false), stepCount(0) {
+    slices.reset(new Slice[workerCount]);
+    partition();
+    for (size_t id = 1; id < workerCount; id++) workers.emplace_back(&FleetRunner::workerLoop, this, id);
+    resetStats();
+}
+
+FleetRunner::~FleetRunner() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &w : workers) w.join();
+}
+
+// Default tanpa output: beberapa worker menulis bersamaan ke cout akan saling menyela
+size_t FleetRunner::add(uint32_t delay, size_t historyCapacity, LogSink *sink) {
+    Instance inst;
+    inst.fsm.reset(new FSM(delay, historyCapacity));
+    inst.fsm->setLogSink(sink ? sink : &NullSink::instance());
+    inst.fsm->setClock(clock);
+    inst.queue.reset(new EventQueue());
+    inst.fsm->setEventQueue(inst.queue.get());
+    inst.startTransitions = inst.fsm->getTransitionCount();
+    instances.push_back(move(inst));
+    return instances.size() - 1;
+}
+
+void FleetRunner::setClock(ClockSource *c) {
+    clock = c ? c : &SteadyClock::instance();
+    for (auto &inst : instances) inst.fsm->setClock(clock);
+}
+ClockSource &FleetRunner::getClock() const { return *clock; }
+
+size_t FleetRunner::size() const { return instances.size(); }
+size_t FleetRunner::getWorkerCount() const { return workerCount; }
+FSM &FleetRunner::instance(size_t i) { return *instances[i].fsm; }
+EventQueue &FleetRunner::queue(size_t i) { return *instances[i].queue; }
+
+// Bagi instance menjadi slice yang sama besar untuk tiap worker
+void FleetRunner::partition() {
+    size_t n = instances.size();
+    for (size_t id = 0; id < workerCount; id++) {
+        slices[id].next.store(n * id / workerCount, memory_order_relaxed);
+        slices[id].end = n * (id + 1) / workerCount;
+    }
+}
+
+// Kerjakan slice sendiri, lalu curi chunk dari slice worker lain
+void FleetRunner::work(size_t id) {
+    for (size_t k = 0; k < workerCount; k++) {
+        Slice &slice = slices[(id + k) % workerCount];
+        while (true) {
+            size_t begin = slice.next.fetch_add(chunk, memory_order_relaxed);
+            if (begin >= slice.end) break;
+            size_t end = min(begin + chunk, slice.end);
+            for (size_t i = begin; i < end; i++) instances[i].fsm->update();
+        }
+    }
+}
+
+void FleetRunner::workerLoop(size_t id) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        work(id);
+        {
+            lock_guard<mutex> guard(lock);
+            if (--running == 0) done.notify_one();
+        }
+    }
+}
+
+// Clock di-tick sekali per step, bukan sekali per instance
+void FleetRunner::step() {
+    clock->tick();
+    partition();
+    {
+        lock_guard<mutex> guard(lock);
+        running = workerCount;
+        generation++;
+    }
+    wake.notify_all();
+    work(0);
+    {
+        unique_lock<mutex> guard(lock);
+        if (--running > 0) done.wait(guard, [&] { return running == 0; });
+    }
+    stepCount++;
+}
+
+void FleetRunner::run(uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) step();
+}
+
+void FleetRunner::resetStats() {
+    for (auto &inst : instances) inst.startTransitions = inst.fsm->getTransitionCount();
+    stepCount = 0;
+    statsStart = chrono::steady_clock::now();
+}
+
+FleetStats FleetRunner::getStats() const {
+    FleetStats stats;
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - statsStart).count();
+    stats.steps = stepCount;
+    stats.transitions = 0;
+    stats.perInstance.reserve(instances.size());
+    for (auto &inst : instances) {
+        uint64_t t = inst.fsm->getTransitionCount() - inst.startTransitions;
+        stats.transitions += t;
+        stats.perInstance.push_back(stats.seconds > 0 ? t / stats.seconds : 0.0);
+    }
+    stats.transitionsPerSecond = stats.seconds > 0 ? stats.transitions / stats.seconds : 0.0;
+    return stats;
+}
+
+void FleetRunner::printStats() const {
+    FleetStats stats = getStats();
+    cout << "[Fleet] Instances=" << instances.size()
+         << " Workers=" << workerCount
+         << " Steps=" << stats.steps
+         << " Transitions=" << stats.transitions
+         << " Rate=" << static_cast<uint64_t>(stats.transitionsPerSecond) << "/s";
+    if (!stats.perInstance.empty()) {
+        auto range = minmax_element(stats.perInstance.begin(), stats.perInstance.end());
+        cout << " PerInstance min=" << static_cast<uint64_t>(*range.first) << "/s"
+             << " max=" << static_cast<uint64_t>(*range.second) << "/s";
+    }
+    cout << endl;
+}
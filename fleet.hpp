@@ -0,0 +1,129 @@
+#ifndef FLEET_H_
+#define FLEET_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "fsm.hpp"
+
+using namespace std;
+
+/**
+ * @brief Transition rates measured by a FleetRunner since its last resetStats().
+ */
+struct FleetStats {
+        double seconds;                 // Measured wall time
+        uint64_t steps;                 // Fleet steps run
+        uint64_t transitions;           // Transitions of every instance
+        double transitionsPerSecond;    // Aggregate rate
+        vector<double> perInstance;     // Transitions per second of each instance
+};
+
+/**
+ * @brief Holds N FSM instances and steps them in parallel on a work-stealing thread pool.
+ * Each worker owns a contiguous slice of the instances and claims chunks of it with an atomic cursor,
+ * a worker done with its slice steals chunks from the other slices the same way.
+ * The calling thread takes part as worker 0. Every instance reads its IDLE commands from its own EventQueue.
+ * @note step() does not allocate. Instances must not be added while a step is running.
+ */
+class FleetRunner {
+
+        private:
+        struct Instance {
+                unique_ptr<FSM> fsm;
+                unique_ptr<EventQueue> queue;
+                uint64_t startTransitions;      // Transition count at the last resetStats()
+        };
+
+        struct alignas(64) Slice {
+                atomic<size_t> next;            // Next instance index to claim
+                size_t end;                     // One past the last index of the slice
+        };
+
+        vector<Instance> instances;
+        unique_ptr<Slice[]> slices;             // One slice per worker
+        vector<thread> workers;                 // Workers 1..N-1, worker 0 is the caller of step()
+        size_t workerCount;
+        size_t chunk;                           // Instances claimed at once
+        ClockSource *clock;                     // Clock of every instance, ticked once per step
+
+        mutex lock;
+        condition_variable wake;                // Signals a new step to the workers
+        condition_variable done;                // Signals the end of a step to the caller
+        uint64_t generation;                    // Incremented for every step
+        size_t running;                         // Workers still stepping the current generation
+        bool stopping;
+
+        uint64_t stepCount;                     // Steps since the last resetStats()
+        chrono::steady_clock::time_point statsStart;
+
+        void workerLoop(size_t id);
+        void work(size_t id);
+        void partition();
+
+        public:
+        /**
+         * @brief Create a fleet runner.
+         * @param threads Number of workers, 0 uses the number of cores.
+         * @param chunk Number of instances a worker claims at once.
+         */
+        explicit FleetRunner(size_t threads = 0, size_t chunk = 8);
+        ~FleetRunner();
+
+        /**
+         * @brief Add an instance reading from its own event queue.
+         * @param sink Destination of its output, null for NullSink. Workers update instances concurrently,
+         * so a shared sink must be thread-safe and keep each write() whole (AsyncSink); SyncSink would interleave lines.
+         * A handler line up to the 256-byte LogLine buffer is one write, a longer one (history, stats export)
+         * can reach the sink in several writes and be interleaved with the lines of other instances.
+         * @return The index of the new instance.
+         * @note The sink is not copied, it must outlive the fleet.
+         */
+        size_t add(uint32_t delay, size_t historyCapacity = 0, LogSink *sink = nullptr);
+
+        /**
+         * @brief Set the clock of every instance, current and added later, ticked once at the start of each step().
+         * @param clock Any clock, or null for SteadyClock::instance(). Workers only read it during a step, so CachedClock and VirtualClock
+         * are safe and advance once per fleet tick whatever the fleet size.
+         * @note The clock is not copied, it must outlive the fleet.
+         */
+        void setClock(ClockSource *clock);
+        ClockSource &getClock() const;
+
+        size_t size() const;
+        size_t getWorkerCount() const;
+        FSM &instance(size_t i);
+        EventQueue &queue(size_t i);
+
+        /**
+         * @brief Tick the fleet clock, call update() once on every instance, in parallel, and wait until all are done.
+         */
+        void step();
+
+        /**
+         * @brief Run step() count times.
+         */
+        void run(uint64_t count);
+
+        /**
+         * @brief Restart the transition rate measurement.
+         */
+        void resetStats();
+
+        /**
+         * @brief Get the per-instance and aggregate transition rates since the last resetStats().
+         */
+        FleetStats getStats() const;
+
+        /**
+         * @brief Print the aggregate transition rate and the slowest and fastest instance.
+         */
+        void printStats() const;
+};
+
+#endif // FLEET_H_
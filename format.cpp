@@ -0,0 +1,59 @@
+#include "format.hpp"
+
+using namespace std;
+
+HistoryRenderer::HistoryRenderer() : base(0), firstSequence(0), endSequence(0) {}
+
+void HistoryRenderer::reset() {
+    text.clear();
+    starts.clear();
+    base = 0;
+    firstSequence = 0;
+    endSequence = 0;
+}
+
+// Format satu entry ke akhir text, tanpa ostream
+void HistoryRenderer::append(const HistoryEntry &entry) {
+    char item[HISTORY_ENTRY_TEXT];
+    size_t n = formatHistoryEntry(item, entry);
+    starts.push_back(text.size());
+    text.append(item, n);
+    endSequence++;
+}
+
+// Buang entry yang sudah ditimpa ring, geser buffer jika separuhnya sudah mati
+void HistoryRenderer::dropBefore(uint64_t sequence) {
+    if (sequence <= firstSequence) return;
+    base += static_cast<size_t>(sequence - firstSequence);
+    firstSequence = sequence;
+    if (base >= starts.size()) {
+        text.clear();
+        starts.clear();
+        base = 0;
+        return;
+    }
+    if (base * 2 < starts.size()) return;
+    size_t cut = starts[base];
+    text.erase(0, cut);
+    starts.erase(starts.begin(), starts.begin() + static_cast<ptrdiff_t>(base));
+    for (size_t &start : starts) start -= cut;
+    base = 0;
+}
+
+const char *HistoryRenderer::render(const StateHistory &history, size_t &length) {
+    uint64_t first = history.firstSequence();
+    uint64_t end = history.endSequence();
+    if (end < endSequence || first < firstSequence) {
+        reset();
+        firstSequence = endSequence = first;
+    }
+    if (endSequence < first) {
+        reset();
+        firstSequence = endSequence = first;
+    }
+    dropBefore(first);
+    while (endSequence < end) append(history.bySequence(endSequence));
+    size_t offset = base < starts.size() ? starts[base] : text.size();
+    length = text.size() - offset;
+    return text.data() + offset;
+}
@@ -0,0 +1,77 @@
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "state.hpp"
+#include "history.hpp"
+
+using namespace std;
+
+/**
+ * @brief Write the decimal digits of value at out with std::to_chars.
+ * @return The number of characters written, at most 20.
+ */
+inline size_t formatDecimal(char *out, uint64_t value) { return static_cast<size_t>(to_chars(out, out + 20, value).ptr - out); }
+inline size_t formatDecimal(char *out, int64_t value) { return static_cast<size_t>(to_chars(out, out + 20, value).ptr - out); }
+
+/**
+ * @brief Longest text of one history entry written by formatHistoryEntry().
+ */
+const size_t HISTORY_ENTRY_TEXT = 48;
+
+/**
+ * @brief Write one history entry as printed by FSM::printStateHistory(), " (state,ms)".
+ * @param out At least HISTORY_ENTRY_TEXT characters.
+ * @return The number of characters written.
+ */
+inline size_t formatHistoryEntry(char *out, const HistoryEntry &entry) {
+        size_t n = 0;
+        out[n++] = ' ';
+        out[n++] = '(';
+        n += formatDecimal(out + n, static_cast<uint64_t>(entry.first));
+        out[n++] = ',';
+        n += formatDecimal(out + n, static_cast<uint64_t>(static_cast<uint32_t>(entry.second / NANOS_PER_MILLI)));
+        out[n++] = ')';
+        return n;
+}
+
+/**
+ * @brief Incremental text rendering of a ring history, as printed by FSM::printStateHistory().
+ * Each call only formats the entries added since the previous one and keeps the text of the others,
+ * entries dropped by the ring are cut from the front, so printing the history every status costs O(new entries) formatting.
+ * The kept text is bounded by twice the ring capacity at about 10 bytes per entry, which is why FSM only uses it
+ * for bounded histories; unbounded and compact histories are formatted straight into the sink on every print.
+ * @note The text is rebuilt from scratch if the history goes back in time (clear, restore, mode switch).
+ */
+class HistoryRenderer {
+
+        private:
+        string text;                    // Rendered entries, from starts[base] on
+        vector<size_t> starts;          // Offset of each rendered entry in text
+        size_t base;                    // Index in starts of the first live entry
+        uint64_t firstSequence;         // Sequence number of starts[base]
+        uint64_t endSequence;           // Sequence number after the last rendered entry
+
+        void append(const HistoryEntry &entry);
+        void dropBefore(uint64_t sequence);
+
+        public:
+        HistoryRenderer();
+
+        /**
+         * @brief Forget the rendered text.
+         */
+        void reset();
+
+        /**
+         * @brief Render the entries of a history added since the last call.
+         * @return The text of every entry of the history, valid until the next call.
+         */
+        const char *render(const StateHistory &history, size_t &length);
+};
+
+#endif // FORMAT_H_
@@ -2,30 +2,65 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <cstring>
 
 using namespace std;
 
+static const uint8_t NO_HISTORY = 0xFF;
+
 // Definisi millis() sesuai header
 uint32_t millis() {
-    static auto start_time = chrono::steady_clock::now();
-    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start_time).count();
+    return SteadyClock::instance().millis();
 }
 
 // Konstruktor default
-FSM::FSM() : currentState(SystemState::INIT), lastHeartbeat(0), delay(0), errorCount(0), moveCount(0) {
+FSM::FSM() : currentState(SystemState::INIT), hooks(0), promptShown(false), moveCount(0), errorCount(0), lastHeartbeat(0), transitionCount(0), clock(&SteadyClock::instance()), sink(&SyncSink::standard()), eventQueue(nullptr), transitionTable(nullptr), batching(false), delay(0), historyMode(HistoryMode::FULL), journal(nullptr), broadcast(nullptr), recording(nullptr), handlerTiming(false), errorRequested(false), taskState(SystemState::INIT), snapshotFile(nullptr), snapshotInterval(1), updatesSinceSnapshot(0) {
+    stats.reset(clock->nanos());
+    for (size_t i = 0; i < SUPERSTATE_LIMIT; i++) deepHistory[i] = NO_HISTORY;
+    for (size_t i = 0; i < STATE_COUNT; i++) coroutineHandlers[i] = nullptr;
+    publish();
     stateHistory.clear();
-    stateHistory.emplace_back(currentState, lastHeartbeat);
+    stateHistory.push(currentState, lastHeartbeat);
 }
 
 // Konstruktor dengan delay
-FSM::FSM(uint32_t delay_ms) : currentState(SystemState::INIT), lastHeartbeat(0), delay(delay_ms), errorCount(0), moveCount(0) {
+FSM::FSM(uint32_t delay_ms) : currentState(SystemState::INIT), hooks(0), promptShown(false), moveCount(0), errorCount(0), lastHeartbeat(0), transitionCount(0), clock(&SteadyClock::instance()), sink(&SyncSink::standard()), eventQueue(nullptr), transitionTable(nullptr), batching(false), delay(delay_ms), historyMode(HistoryMode::FULL), journal(nullptr), broadcast(nullptr), recording(nullptr), handlerTiming(false), errorRequested(false), taskState(SystemState::INIT), snapshotFile(nullptr), snapshotInterval(1), updatesSinceSnapshot(0) {
+    stats.reset(clock->nanos());
+    for (size_t i = 0; i < SUPERSTATE_LIMIT; i++) deepHistory[i] = NO_HISTORY;
+    for (size_t i = 0; i < STATE_COUNT; i++) coroutineHandlers[i] = nullptr;
+    publish();
     stateHistory.clear();
-    stateHistory.emplace_back(currentState, lastHeartbeat);
+    stateHistory.push(currentState, lastHeartbeat);
+}
+
+// Konstruktor dengan delay dan history ring berkapasitas tetap
+FSM::FSM(uint32_t delay_ms, size_t historyCapacity, pmr::memory_resource *resource) : currentState(SystemState::INIT), hooks(0), promptShown(false), moveCount(0), errorCount(0), lastHeartbeat(0), transitionCount(0), clock(&SteadyClock::instance()), sink(&SyncSink::standard()), eventQueue(nullptr), transitionTable(nullptr), batching(false), delay(delay_ms),
+    stateHistory(historyCapacity, resource), compactHistory(resource), historyMode(HistoryMode::FULL), journal(nullptr), broadcast(nullptr), recording(nullptr), handlerTiming(false), errorRequested(false), taskState(SystemState::INIT), snapshotFile(nullptr), snapshotInterval(1), updatesSinceSnapshot(0) {
+    stats.reset(clock->nanos());
+    for (size_t i = 0; i < SUPERSTATE_LIMIT; i++) deepHistory[i] = NO_HISTORY;
+    for (size_t i = 0; i < STATE_COUNT; i++) coroutineHandlers[i] = nullptr;
+    publish();
+    stateHistory.push(currentState, lastHeartbeat);
+}
+
+// Konstruktor dari config: langsung di initialState, tanpa output, history dialokasikan sekali
+FSM::FSM(const FsmConfig &config, pmr::memory_resource *resource) : currentState(config.initialState), hooks(0), promptShown(false), moveCount(0), errorCount(0), lastHeartbeat(0), transitionCount(0),
+    clock(config.clock == ClockChoice::TSC ? static_cast<ClockSource *>(&TscClock::instance()) : &SteadyClock::instance()),
+    sink(config.sink == SinkChoice::NONE ? static_cast<LogSink *>(&NullSink::instance()) : &SyncSink::standard()), eventQueue(nullptr), transitionTable(nullptr), batching(false), delay(config.delay),
+    stateHistory(config.historyCapacity, resource), compactHistory(resource), historyMode(config.historyMode), journal(nullptr), broadcast(nullptr), recording(nullptr), handlerTiming(false), errorRequested(false), taskState(SystemState::INIT), snapshotFile(nullptr), snapshotInterval(1), updatesSinceSnapshot(0) {
+    stats.reset(clock->nanos());
+    for (size_t i = 0; i < SUPERSTATE_LIMIT; i++) deepHistory[i] = NO_HISTORY;
+    for (size_t i = 0; i < STATE_COUNT; i++) coroutineHandlers[i] = nullptr;
+    refreshHooks();
+    if (historyMode == HistoryMode::FULL) stateHistory.reserve(config.historyReserve);
+    recordHistory(currentState, lastHeartbeat);
+    publish();
 }
 
 // Destruktor
 FSM::~FSM() {
     stateHistory.clear();
+    compactHistory.clear();
 }
 
 // Getter current state
@@ -35,38 +70,174 @@ SystemState FSM::getCurrentState() const {
 
 // Transisi ke state baru
 void FSM::transitionToState(SystemState newState) {
+    enterState(newState, clock->nanos());
+    publish();
+}
+
+// Semua pencatatan transisi dengan waktu yang sudah diambil, tanpa publish
+void FSM::enterState(SystemState newState, uint64_t now, bool timed) {
+    if (timed) stats.recordTransition(currentState, newState, now);
+    else       stats.recordUntimedTransition(currentState, newState);
+    // Tanpa fitur opsional: cukup satu cek untuk semuanya
+    if (!(hooks & ENTER_HOOKS)) {
+        currentState = newState;
+        transitionCount++;
+        lastHeartbeat = static_cast<uint32_t>(now / NANOS_PER_MILLI);
+        stateHistory.push(newState, now);
+        return;
+    }
+    if (transitionTable) {
+        for (uint8_t exited = transitionTable->exits(currentState, newState); exited; exited &= exited - 1) {
+            deepHistory[__builtin_ctz(exited)] = static_cast<uint8_t>(currentState);
+        }
+    }
+    if (broadcast) broadcast->publish(currentState, newState, now);
     currentState = newState;
-    lastHeartbeat = millis();
-    stateHistory.emplace_back(newState, lastHeartbeat);
+    transitionCount++;
+    lastHeartbeat = static_cast<uint32_t>(now / NANOS_PER_MILLI);
+    recordHistory(newState, now);
+    if (journal) journal->append(newState, now, moveCount, errorCount);
 }
 
+uint64_t FSM::getTransitionCount() const { return transitionCount; }
+
 void FSM::setDelay(uint32_t d) { delay = d; }
 void FSM::getDelay(uint32_t &d) const { d = delay; }
-void FSM::setErrorCount(int count) { errorCount = count; }
+void FSM::setErrorCount(int count) { errorCount = count; publish(); }
 int FSM::getErrorCount() const { return errorCount; }
-void FSM::setMoveCount(int count) { moveCount = count; }
+void FSM::setMoveCount(int count) { moveCount = count; publish(); }
 int FSM::getMoveCount() const { return moveCount; }
 
 void FSM::addStateToHistory(SystemState state, uint32_t time) {
-    stateHistory.emplace_back(state, time);
+    recordHistory(state, static_cast<uint64_t>(time) * NANOS_PER_MILLI);
+}
+void FSM::recordHistory(SystemState state, uint64_t timeNs) {
+    if (historyMode == HistoryMode::COMPACT) compactHistory.push(state, timeNs);
+    else                                     stateHistory.push(state, timeNs);
+}
+vector<HistoryEntry> FSM::getStateHistoryNanos() const {
+    if (historyMode == HistoryMode::COMPACT) return compactHistory.toVector();
+    return stateHistory.toVector();
+}
+uint64_t FSM::getLastTransitionNanos() const {
+    if (historyMode == HistoryMode::COMPACT) return compactHistory.getLastTime();
+    HistoryView view = stateHistory.view();
+    return view.empty() ? 0 : view[view.size() - 1].second;
 }
 vector<pair<SystemState, uint32_t>> FSM::getStateHistory() const {
-    return stateHistory;
+    vector<HistoryEntry> entries = getStateHistoryNanos();
+    vector<pair<SystemState, uint32_t>> out;
+    out.reserve(entries.size());
+    for (auto &entry : entries) out.emplace_back(entry.first, static_cast<uint32_t>(entry.second / NANOS_PER_MILLI));
+    return out;
+}
+
+// Pindahkan histori ke storage yang baru
+void FSM::setHistoryMode(HistoryMode mode) {
+    if (mode == historyMode) return;
+    vector<HistoryEntry> entries = getStateHistoryNanos();
+    stateHistory.clear();
+    compactHistory.clear();
+    historyMode = mode;
+    refreshHooks();
+    historyRenderer.reset();
+    for (auto &entry : entries) recordHistory(entry.first, entry.second);
 }
+HistoryMode FSM::getHistoryMode() const { return historyMode; }
+const CompactHistory &FSM::getCompactHistory() const { return compactHistory; }
+uint64_t FSM::getHistoryOverwritten() const { return stateHistory.getOverwritten(); }
+HistoryView FSM::historyView() const { return stateHistory.view(); }
+HistoryView FSM::historySince(uint64_t seq) const { return stateHistory.since(seq); }
 uint32_t FSM::getLastHeartbeat() const { return lastHeartbeat; }
-void FSM::setLastHeartbeat(uint32_t heartbeat) { lastHeartbeat = heartbeat; }
+void FSM::setLastHeartbeat(uint32_t heartbeat) { lastHeartbeat = heartbeat; publish(); }
+
+// Publikasikan state dan counter untuk thread monitor
+void FSM::publish() {
+    if (batching) return;
+    observation.publish({currentState, lastHeartbeat, moveCount, errorCount});
+}
+Observation FSM::observe() const { return observation.read(); }
+const ObservationSeqlock &FSM::getObservation() const { return observation; }
+SystemState FSM::getDeepHistory(Superstate superstate, SystemState initial) const {
+    uint8_t state = superstate < SUPERSTATE_LIMIT ? deepHistory[superstate] : NO_HISTORY;
+    return state == NO_HISTORY ? initial : static_cast<SystemState>(state);
+}
+
+void FSM::requestError() { errorRequested.store(true, memory_order_release); }
 
 // Start FSM: inisialisasi lalu loop hingga STOPPED
 void FSM::start() {
-    performInit();
+    clock->tick();
+    if (currentState == SystemState::INIT) performInit();
+    resume();
+}
+
+// Loop utama tanpa inisialisasi
+void FSM::resume() {
+    while (currentState != SystemState::STOPPED) {
+        clock->tick();
+        update();
+    }
+    shutdown();
+}
+
+// Sama seperti start(), tapi setiap update() mengikuti deadline scheduler
+void FSM::run(TickScheduler &scheduler) {
+    // State hasil restore() atau config tidak diinisialisasi ulang
+    if (currentState == SystemState::INIT) {
+        scheduler.waitNextTick();
+        clock->tick();
+        performInit();
+        scheduler.endTick();
+    }
     while (currentState != SystemState::STOPPED) {
+        scheduler.waitNextTick();
+        clock->tick();
         update();
+        scheduler.endTick();
     }
     shutdown();
 }
 
+void FSM::startScheduled(uint32_t spinTailUs) {
+    TickScheduler scheduler(delay, spinTailUs);
+    run(scheduler);
+    scheduler.printStats();
+}
+
 // Update sesuai state saat ini
 void FSM::update() {
+    if (errorRequested.load(memory_order_relaxed) && errorRequested.exchange(false, memory_order_acquire)) {
+        LogLine(*sink) << "Watchdog timeout in " << stateName(currentState) << "!\n";
+        transitionToState(SystemState::ERROR);
+        return;
+    }
+    if (!handlerTiming) {
+        runHandler();
+    } else {
+        SystemState state = currentState;
+        uint64_t start = clock->nanos();
+        runHandler();
+        stats.recordHandler(state, clock->nanos() - start);
+    }
+    if (snapshotFile && ++updatesSinceSnapshot >= snapshotInterval) {
+        updatesSinceSnapshot = 0;
+        capture(snapshotBuffer);
+        if (!snapshotFile->write(snapshotBuffer)) LogLine(*sink) << "Snapshot write failed\n";
+    }
+}
+
+// Handler state saat ini
+void FSM::runHandler() {
+    if ((task || coroutineHandlers[static_cast<size_t>(currentState)]) && runCoroutine()) return;
+    if (eventQueue && currentState == SystemState::IDLE) {
+        pollEvents();
+        return;
+    }
+    if (transitionTable) {
+        dispatch(currentState == SystemState::IDLE ? commandToEvent(readCommand()) : Event::TICK);
+        return;
+    }
     switch (currentState) {
         case SystemState::INIT:        performInit();         break;
         case SystemState::IDLE:        performProcess();      break;
@@ -78,73 +249,275 @@ void FSM::update() {
     }
 }
 
+void FSM::refreshHooks() {
+    bool coroutines = false;
+    for (CoroutineHandler handler : coroutineHandlers) coroutines |= handler != nullptr;
+    hooks = (transitionTable ? HOOK_TABLE : 0) | (journal ? HOOK_JOURNAL : 0) | (broadcast ? HOOK_BROADCAST : 0)
+          | (historyMode == HistoryMode::COMPACT ? HOOK_COMPACT : 0) | (handlerTiming ? HOOK_TIMING : 0)
+          | (snapshotFile ? HOOK_SNAPSHOT : 0) | (coroutines ? HOOK_COROUTINE : 0) | (recording ? HOOK_RECORDING : 0);
+}
+
+void FSM::setLogSink(LogSink *s) { sink = s ? s : &SyncSink::standard(); }
+LogSink &FSM::getLogSink() const { return *sink; }
+
+void FSM::setJournal(Journal *j) { journal = j; refreshHooks(); }
+Journal *FSM::getJournal() const { return journal; }
+void FSM::setBroadcast(StateBroadcast *b) { broadcast = b; refreshHooks(); }
+StateBroadcast *FSM::getBroadcast() const { return broadcast; }
+
+void FSM::setClock(ClockSource *c) { clock = c ? c : &SteadyClock::instance(); }
+ClockSource &FSM::getClock() const { return *clock; }
+void FSM::setInputRecording(InputRecording *r) { recording = r; refreshHooks(); }
+
+const FsmStats &FSM::getStats() const { return stats; }
+void FSM::resetStats() { stats.reset(clock->nanos()); }
+void FSM::setHandlerTiming(bool enabled) { handlerTiming = enabled; refreshHooks(); }
+
+void FSM::exportStats(ostream &out, bool prometheus) const {
+    if (prometheus) exportPrometheus(out, stats.snapshot());
+    else exportPlaintext(out, stats.snapshot());
+}
+
+void FSM::setCoroutineHandler(SystemState state, CoroutineHandler handler) {
+    coroutineHandlers[static_cast<size_t>(state)] = handler;
+    refreshHooks();
+    if (task && taskState == state) task = Task();
+}
+
+FramePool &FSM::getFramePool() { return framePool; }
+
+// Batalkan coroutine jika state sudah berganti, mulai yang baru jika perlu, lalu lanjutkan
+bool FSM::runCoroutine() {
+    if (task && taskState != currentState) task = Task();
+    if (!task) {
+        CoroutineHandler handler = coroutineHandlers[static_cast<size_t>(currentState)];
+        if (!handler) return false;
+        task = handler(*this);
+        taskState = currentState;
+    }
+    if (task.step(*clock, eventQueue)) task = Task();
+    // Masih menunggu di state yang sama: FSM hidup, heartbeat diperbarui agar watchdog tidak memicu ERROR palsu
+    else if (taskState == currentState) {
+        lastHeartbeat = clock->millis();
+        publish();
+    }
+    return true;
+}
+
+// Salin semua field ke blok trivially copyable dan history ke vector
+void FSM::capture(FsmSnapshot &snapshot) const {
+    FsmCoreState &core = snapshot.core;
+    memset(&core, 0, sizeof(core));
+    core.transitionCount = transitionCount;
+    core.historyFirstSequence = stateHistory.firstSequence();
+    core.historyOverwritten = stateHistory.getOverwritten();
+    core.lastHeartbeat = lastHeartbeat;
+    core.delay = delay;
+    core.errorCount = errorCount;
+    core.moveCount = moveCount;
+    core.state = static_cast<uint8_t>(currentState);
+    core.historyMode = static_cast<uint8_t>(historyMode);
+    memcpy(core.deepHistory, deepHistory, sizeof(deepHistory));
+    snapshot.history.clear();
+    if (historyMode == HistoryMode::COMPACT) {
+        CompactHistory::Cursor cursor = compactHistory.cursor();
+        HistoryEntry entry;
+        while (cursor.next(entry)) snapshot.history.push_back(entry);
+        return;
+    }
+    stateHistory.copyTo(snapshot.history);
+}
+
+bool FSM::restore(const FsmSnapshot &snapshot) {
+    if (!isValidSnapshot(snapshot)) return false;
+    const FsmCoreState &core = snapshot.core;
+    transitionCount = core.transitionCount;
+    lastHeartbeat = core.lastHeartbeat;
+    delay = core.delay;
+    errorCount = core.errorCount;
+    moveCount = core.moveCount;
+    currentState = static_cast<SystemState>(core.state);
+    historyMode = static_cast<HistoryMode>(core.historyMode);
+    refreshHooks();
+    memcpy(deepHistory, core.deepHistory, sizeof(deepHistory));
+    task = Task();
+    historyRenderer.reset();
+    compactHistory.clear();
+    if (historyMode == HistoryMode::COMPACT) {
+        stateHistory.clear();
+        for (const HistoryEntry &entry : snapshot.history) compactHistory.push(entry.first, entry.second);
+    } else {
+        stateHistory.restore(snapshot.history, core.historyFirstSequence, core.historyOverwritten);
+    }
+    promptShown = false;
+    stats.reset(clock->nanos());
+    publish();
+    return true;
+}
+
+void FSM::setSnapshotFile(SnapshotFile *file, uint32_t everyUpdates) {
+    snapshotFile = file;
+    snapshotInterval = everyUpdates ? everyUpdates : 1;
+    updatesSinceSnapshot = 0;
+    refreshHooks();
+}
+
+void FSM::setTransitionTable(const TransitionTable *table) { transitionTable = table; refreshHooks(); }
+const TransitionTable *FSM::getTransitionTable() const { return transitionTable; }
+
+void FSM::setEventQueue(EventQueue *queue) { eventQueue = queue; promptShown = false; }
+EventQueue *FSM::getEventQueue() const { return eventQueue; }
+
+// Ambil semua command yang tertunda tanpa blocking
+void FSM::pollEvents() {
+    Event event;
+    while (currentState == SystemState::IDLE) {
+        if (!promptShown) showPrompt();
+        if (!eventQueue->pop(event)) {
+            lastHeartbeat = clock->millis();
+            publish();
+            return;
+        }
+        promptShown = false;
+        if (recording) recording->record(clock->millis(), static_cast<int32_t>(event), event);
+        dispatch(event);
+    }
+}
+
+// Dispatch lewat tabel transisi
+void FSM::dispatch(Event event) {
+    const TransitionTable &table = transitionTable ? *transitionTable : TransitionTable::defaultTable();
+    const Transition &t = table.get(currentState, event);
+    SystemState next = t.resume ? getDeepHistory(t.resume - 1, t.next) : t.next;
+    if (t.action) next = t.action(*this, next);
+    if (next != currentState) transitionToState(next);
+}
+
+// Dispatch banyak event dengan satu timestamp dan satu reserve history, satu publish di akhir
+size_t FSM::applyEvents(span<const Event> events) {
+    const TransitionTable &table = transitionTable ? *transitionTable : TransitionTable::defaultTable();
+    uint64_t now = clock->nanos();
+    if (historyMode == HistoryMode::FULL) stateHistory.reserve(events.size());
+    uint64_t before = transitionCount;
+    batching = true;
+    for (Event event : events) {
+        const Transition &t = table.get(currentState, event);
+        SystemState next = t.resume ? getDeepHistory(t.resume - 1, t.next) : t.next;
+        if (t.action) next = t.action(*this, next);
+        if (next != currentState) enterState(next, now, transitionCount == before);
+    }
+    batching = false;
+    publish();
+    return static_cast<size_t>(transitionCount - before);
+}
+
 // Cetak status ringkas
 void FSM::printStatus() {
-    cout << "[Status] State=" << static_cast<int>(currentState)
-         << " MoveCount=" << moveCount
-         << " Errors=" << errorCount << endl;
+    LogLine(*sink) << "[Status] State=" << static_cast<int>(currentState)
+                   << " MoveCount=" << moveCount
+                   << " Errors=" << errorCount << "\n";
 }
 
 // Cetak histori state
 void FSM::printStateHistory() {
-    cout << "[History]";
-    for (auto &entry : stateHistory) {
-        cout << " (" << static_cast<int>(entry.first) << "," << entry.second << ")";
+    LogLine line(*sink);
+    line << "[History]";
+    char item[HISTORY_ENTRY_TEXT];
+    if (historyMode == HistoryMode::COMPACT) {
+        CompactHistory::Cursor cursor = compactHistory.cursor();
+        HistoryEntry entry;
+        while (cursor.next(entry)) line.write(item, formatHistoryEntry(item, entry));
+    } else if (stateHistory.getCapacity() == 0) {
+        // History tanpa batas: format langsung ke sink, tanpa menyimpan text yang terus tumbuh
+        for (const HistoryEntry &entry : stateHistory.view()) line.write(item, formatHistoryEntry(item, entry));
+    } else {
+        if (stateHistory.getOverwritten() > 0) line << " (overwritten=" << stateHistory.getOverwritten() << ")";
+        size_t length;
+        const char *text = historyRenderer.render(stateHistory, length);
+        line.write(text, length);
     }
-    cout << endl;
+    line << "\n";
+}
+
+// Cetak perbandingan memori histori
+void FSM::printHistoryFootprint() {
+    HistoryFootprint fp;
+    if (historyMode == HistoryMode::COMPACT) {
+        fp = compactHistory.footprint();
+    } else {
+        CompactHistory packed;
+        for (size_t i = 0; i < stateHistory.size(); i++) packed.push(stateHistory.at(i).first, stateHistory.at(i).second);
+        fp = packed.footprint();
+    }
+    LogLine(*sink) << "[Footprint] Entries=" << static_cast<uint64_t>(fp.entries)
+                   << " Pair=" << static_cast<uint64_t>(fp.pairBytes) << "B (" << static_cast<uint64_t>(sizeof(HistoryEntry)) << "B/entry)"
+                   << " Compact=" << static_cast<uint64_t>(fp.compactBytes) << "B\n";
 }
 
 // Inisialisasi
 void FSM::performInit() {
-    cout << "Initializing..." << endl;
+    LogLine(*sink) << "Initializing...\n";
     transitionToState(SystemState::IDLE);
 }
 
+void FSM::showPrompt() {
+    printStatus();
+    LogLine(*sink) << "Commands: 1=Status 2=Move 3=Shoot 4=Calc 5=Stop > ";
+    promptShown = true;
+}
+
+// Tampilkan prompt dan baca satu command
+int FSM::readCommand() {
+    showPrompt();
+    promptShown = false;
+    int cmd = 0; cin >> cmd;
+    if (recording) recording->record(clock->millis(), cmd, commandToEvent(cmd));
+    return cmd;
+}
+
 // Tunggu input user
 void FSM::performProcess() {
-    printStatus();
-    cout << "Commands: 1=Status 2=Move 3=Shoot 4=Calc 5=Stop > ";
-    int cmd; cin >> cmd;
+    int cmd = readCommand();
     switch (cmd) {
         case 1: printStatus(); printStateHistory(); break;
         case 2: transitionToState(SystemState::MOVEMENT); break;
         case 3: transitionToState(SystemState::SHOOTING); break;
         case 4: transitionToState(SystemState::CALCULATION); break;
         case 5: transitionToState(SystemState::STOPPED); break;
-        default: cout<<"Invalid"<<endl; transitionToState(SystemState::ERROR);
+        default: LogLine(*sink) << "Invalid\n"; transitionToState(SystemState::ERROR);
     }
 }
 
 // Proses Movement
 void FSM::performMovement() {
-    cout << "Moving..." << endl;
+    LogLine(*sink) << "Moving...\n";
     moveCount++;
     transitionToState(moveCount>=3 ? SystemState::SHOOTING : SystemState::IDLE);
 }
 
 // Proses Shooting
 void FSM::performShooting() {
-    cout << "Shooting..." << endl;
+    LogLine(*sink) << "Shooting...\n";
     moveCount = 0;
     transitionToState(SystemState::IDLE);
 }
 
 // Proses Calculation
 void FSM::performCalculation() {
-    cout << "Calculating..." << endl;
+    LogLine(*sink) << "Calculating...\n";
     if (moveCount==0) transitionToState(SystemState::ERROR);
     else               transitionToState(SystemState::IDLE);
 }
 
 // Handle Error
 void FSM::performErrorHandling() {
-    cout << "Error!" << endl;
+    LogLine(*sink) << "Error!\n";
     errorCount++;
     transitionToState(errorCount>3 ? SystemState::STOPPED : SystemState::IDLE);
 }
 
 // Shutdown
 void FSM::shutdown() {
-    cout << "Shutting down..." << endl;
+    LogLine(*sink) << "Shutting down...\n";
     printStateHistory();
 }
@@ -1,35 +1,133 @@
 #ifndef FSM_H_
 #define FSM_H_
 
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <cstdint>
 #include <chrono>
+#include <span>
 #include <vector>
+#include "state.hpp"
+#include "history.hpp"
+#include "transition_table.hpp"
+#include "event_queue.hpp"
+#include "scheduler.hpp"
+#include "log_sink.hpp"
+#include "journal.hpp"
+#include "clock.hpp"
+#include "replay.hpp"
+#include "stats.hpp"
+#include "observation.hpp"
+#include "coroutine.hpp"
+#include "snapshot.hpp"
+#include "format.hpp"
+#include "state_broadcast.hpp"
+#include "config.hpp"
 
 using namespace std;
 
-enum class SystemState {
-        INIT,
-        IDLE,
-        MOVEMENT,
-        SHOOTING,
-        CALCULATION,
-        ERROR,
-        STOPPED
-};
-
+/**
+ * @brief Get the time in milliseconds of SteadyClock::instance(), the default clock of every FSM.
+ */
 uint32_t millis();
 
 class FSM {
 
         private:
-        SystemState currentState;       // Current state of the FSM
+        // Hot fields, read or written by every update() of the IDLE/MOVEMENT cycle, packed into the first cache line
+        alignas(64) SystemState currentState;   // Current state of the FSM
+        uint8_t hooks;                  // HOOK_* bits of the optional features in use, one test skips all of them
+        bool promptShown;               // The IDLE prompt was printed and no command arrived yet
+        int moveCount;                  // Count of movements performed, if 3 moves are performed, the FSM will transition to SHOOTING state.
+        int errorCount;                 // Count of errors encountered
         uint32_t lastHeartbeat;            // Last heartbeat time in milliseconds
+        uint64_t transitionCount;       // Number of transitions since construction
+        ClockSource *clock;             // Time source of heartbeats and history
+        LogSink *sink;                  // Destination of the handler output
+        EventQueue *eventQueue;         // Non-blocking command input for IDLE, null to read cin
+        const TransitionTable *transitionTable;  // Table used by update(), null to use the perform*() switch
+        bool batching;                  // Inside applyEvents(): publish() waits for the end of the batch
+
+        // Cold fields
         uint32_t delay;                 // Delay in milliseconds for each state transition
-        int errorCount;                 // Count of errors encountered
-        vector<pair<SystemState, uint32_t>> stateHistory;  // List of state and time pairs
-        int moveCount;              // Count of movements performed, if 3 moves are performed, the FSM will transition to SHOOTING state.
+        StateHistory stateHistory;      // List of state and time pairs, optionally a bounded ring
+        CompactHistory compactHistory;  // Packed history, used instead of stateHistory in COMPACT mode
+        HistoryMode historyMode;        // Storage used for the history
+        Journal *journal;               // Binary transition journal, null if disabled
+        StateBroadcast *broadcast;      // Ring read by state subscribers, null if disabled
+        InputRecording *recording;      // Receives every IDLE command, null if not recording
+        FsmStats stats;                 // Per-state counters, updated on every transition
+        bool handlerTiming;             // Time every update() into the stats handler histograms
+        ObservationSeqlock observation; // State, heartbeat and counters published for monitor threads
+        atomic<bool> errorRequested;    // Set by requestError(), consumed by the next update()
+        uint8_t deepHistory[SUPERSTATE_LIMIT];  // Substate active when each superstate was last left, NO_HISTORY if never
+        CoroutineHandler coroutineHandlers[STATE_COUNT];        // Coroutine replacing the handler of each state, null for none
+        FramePool framePool;            // Frames of the coroutine handlers, declared before task so it outlives it
+        Task task;                      // Running coroutine handler, empty if none
+        SystemState taskState;          // State the running coroutine handler was started in
+        SnapshotFile *snapshotFile;     // Receives a snapshot every snapshotInterval updates, null if disabled
+        uint32_t snapshotInterval;      // Updates between two snapshots
+        uint32_t updatesSinceSnapshot;  // Updates since the last snapshot
+        FsmSnapshot snapshotBuffer;     // Reused by the periodic snapshots
+        HistoryRenderer historyRenderer;        // Text of the ring history entries already printed, unused for unbounded histories
+
+        static const uint8_t HOOK_TABLE = 1 << 0;       // transitionTable set
+        static const uint8_t HOOK_JOURNAL = 1 << 1;     // journal set
+        static const uint8_t HOOK_BROADCAST = 1 << 2;   // broadcast set
+        static const uint8_t HOOK_COMPACT = 1 << 3;     // COMPACT history mode
+        static const uint8_t HOOK_TIMING = 1 << 4;      // handlerTiming on
+        static const uint8_t HOOK_SNAPSHOT = 1 << 5;    // snapshotFile set
+        static const uint8_t HOOK_COROUTINE = 1 << 6;   // A coroutine handler is set
+        static const uint8_t HOOK_RECORDING = 1 << 7;   // recording set
+        static const uint8_t ENTER_HOOKS = HOOK_TABLE | HOOK_JOURNAL | HOOK_BROADCAST | HOOK_COMPACT;
+
+        /**
+         * @brief Recompute hooks from the optional feature fields, after any of them changed.
+         */
+        void refreshHooks();
+
+        /**
+         * @brief Print the status and the command prompt, then read one command from cin.
+         */
+        int readCommand();
+
+        /**
+         * @brief Enter a state at the given time: stats, deep history, heartbeat, history and journal, but no publish().
+         * @param timed false if the visit being left has no measured duration, it then adds no dwell time to the stats.
+         */
+        void enterState(SystemState newState, uint64_t now, bool timed = true);
+
+        /**
+         * @brief Record a state entered at timeNs in the selected history storage.
+         */
+        void recordHistory(SystemState state, uint64_t timeNs);
+
+        /**
+         * @brief Print the command prompt once per wait.
+         */
+        void showPrompt();
+
+        /**
+         * @brief Dispatch the pending commands of eventQueue while in IDLE, refresh the heartbeat if there are none.
+         */
+        void pollEvents();
+
+        /**
+         * @brief Run the handler of the current state, the body of update().
+         */
+        void runHandler();
+
+        /**
+         * @brief Start or resume the coroutine handler of the current state.
+         * @return false if the state has no coroutine handler, the usual handler must run.
+         */
+        bool runCoroutine();
+
+        /**
+         * @brief Publish the current state, heartbeat and counters to the observation seqlock, deferred while batching.
+         */
+        void publish();
 
         public: 
         /**
@@ -47,6 +145,24 @@ class FSM {
          */
         FSM(uint32_t delay);
 
+        /**
+         * @brief set currentState to INIT, lastHeartbeat and errorCount to 0, set delay to param,
+         * keep at most historyCapacity entries in a preallocated ring buffer.
+         * @param delay The delay in milliseconds for each state transition.
+         * @param historyCapacity Number of history slots, 0 keeps the unbounded history.
+         * @param resource Memory resource of both history storages, for example the one of an FSMArena.
+         * @note Once the ring is full, transitions overwrite the oldest entry without allocating. The resource must outlive the FSM.
+         */
+        FSM(uint32_t delay, size_t historyCapacity, pmr::memory_resource *resource = pmr::get_default_resource());
+
+        /**
+         * @brief Cold-start from a config: state, delay, clock and sink come from config, nothing is printed,
+         * and the history gets its ring or config.historyReserve entries in one allocation.
+         * @param resource Memory resource of both history storages, as for the constructor above.
+         * @note Starting in IDLE makes start() skip performInit(), see start().
+         */
+        explicit FSM(const FsmConfig &config, pmr::memory_resource *resource = pmr::get_default_resource());
+
         /**
          * @brief Destructor for the FSM class.
          * @note This is a destructor, by default C++ will generate a default destructor if none is provided.
@@ -69,6 +185,11 @@ class FSM {
          */
         void transitionToState(SystemState newState);
 
+        /**
+         * @brief Get the number of transitions done since the FSM was constructed.
+         */
+        uint64_t getTransitionCount() const;
+
         /**
          * @brief set the delay for the FSM.
          * @param delay The delay in milliseconds to set for the FSM.
@@ -109,17 +230,71 @@ class FSM {
          * @brief Add a state and its corresponding time to the state history.
          * @param state The state to add to the history.
          * @param time The time in milliseconds when the state was entered.
-         * @note This function appends a pair of state and time to the stateHistory vector.
+         * @note This function appends a pair of state and time to the stateHistory vector, the history keeps it in nanoseconds.
          */
         void addStateToHistory(SystemState state, uint32_t time);
 
         /**
          * @brief Get the state history of the FSM.
-         * @return A vector of pairs containing the state and the time it was entered.
-         * @note This function returns a copy of the stateHistory vector.
+         * @return A vector of pairs containing the state and the time it was entered, in milliseconds.
+         * @note This function returns a copy of the stateHistory, oldest entry first.
+         * It is kept for compatibility, prefer historyView() or historySince() on hot paths.
          */
         vector<pair<SystemState, uint32_t>> getStateHistory() const;
 
+        /**
+         * @brief Get the number of history entries overwritten by the ring buffer.
+         * @return 0 when the history is unbounded or the ring has not wrapped yet.
+         */
+        uint64_t getHistoryOverwritten() const;
+
+        /**
+         * @brief Select the storage used for the state history.
+         * @param mode FULL keeps pair entries (ring or unbounded), COMPACT packs each entry into a few bytes.
+         * @note Entries already recorded are moved to the new storage. In COMPACT mode the history views are empty,
+         * use getStateHistory() or getCompactHistory() to decode it.
+         */
+        void setHistoryMode(HistoryMode mode);
+
+        /**
+         * @brief Get the storage used for the state history.
+         */
+        HistoryMode getHistoryMode() const;
+
+        /**
+         * @brief Get the packed history, only filled in COMPACT mode.
+         */
+        const CompactHistory &getCompactHistory() const;
+
+        /**
+         * @brief Print the memory used by the history in the pair layout and in the compact encoding.
+         */
+        void printHistoryFootprint();
+
+        /**
+         * @brief Get the history with its full 64-bit nanosecond timestamps, copied in either history mode.
+         */
+        vector<HistoryEntry> getStateHistoryNanos() const;
+
+        /**
+         * @brief Get the time in nanoseconds of the newest history entry, when the current state was entered.
+         * @return 0 if the history is empty.
+         */
+        uint64_t getLastTransitionNanos() const;
+
+        /**
+         * @brief Get a zero-copy view over the state history, oldest entry first.
+         * @note Entry times are in nanoseconds of the FSM clock.
+         * @note The view is invalidated by the next transition.
+         */
+        HistoryView historyView() const;
+
+        /**
+         * @brief Get a zero-copy view over the history entries with a sequence number of at least seq.
+         * @param seq Usually the endSequence() of the view returned by the previous poll.
+         */
+        HistoryView historySince(uint64_t seq) const;
+
         /**
          * @brief Get the last heartbeat time of the FSM.
          * @return The last heartbeat time in milliseconds.
@@ -127,6 +302,31 @@ class FSM {
          */
         uint32_t getLastHeartbeat() const;
 
+        /**
+         * @brief Get the state, heartbeat, moveCount and errorCount as one consistent tuple, from any thread.
+         * The control thread publishes after every transition and setter without ever blocking, readers retry
+         * while a publish is in progress.
+         * @note The plain getters are only safe on the thread running update(), monitor threads should use this.
+         */
+        Observation observe() const;
+
+        /**
+         * @brief Ask the FSM to enter ERROR at its next update(), from any thread.
+         * Used by the Watchdog when a handler stalls, the update after that runs the usual error handling.
+         */
+        void requestError();
+
+        /**
+         * @brief Get the substate that was active when a superstate of the transition table was last left.
+         * @return The state, or the initial substate given if the FSM never left the superstate.
+         */
+        SystemState getDeepHistory(Superstate superstate, SystemState initial) const;
+
+        /**
+         * @brief Get the seqlock behind observe(), so a monitor can keep it instead of the FSM.
+         */
+        const ObservationSeqlock &getObservation() const;
+
         /**
          * @brief Set the last heartbeat time of the FSM.
          * @param heartbeat The time in milliseconds to set as the last heartbeat.
@@ -137,9 +337,25 @@ class FSM {
          * @brief Start the FSM.
          * This function initializes the FSM and begins the state update loop.
          * Create a loop that checks the current state every 1000 milliseconds, 
+         * @note performInit() only runs in INIT, an FSM built from a config with another initial state starts its loop directly.
          */
         void start();
 
+        /**
+         * @brief Start the FSM on a fixed-rate tick schedule.
+         * Same as start(), but each update() begins on a steady_clock deadline of the scheduler,
+         * so the FSM runs at one update per period without drift.
+         * @param scheduler The scheduler driving the ticks, its statistics record overruns and jitter.
+         * @note Use an event queue (setEventQueue()) so IDLE does not block a tick on cin.
+         */
+        void run(TickScheduler &scheduler);
+
+        /**
+         * @brief Start the FSM with one tick every delay milliseconds, then print the tick statistics.
+         * @param spinTailUs Busy-wait tail before each deadline, in microseconds.
+         */
+        void startScheduled(uint32_t spinTailUs = 200);
+
         /**
          * @brief Update the FSM state based on the current state.
          * Check the attribute fsmState to determine its next process:
@@ -152,9 +368,177 @@ class FSM {
          * - STOPPED: Stop the system operations.
          * Update the lastHeartbeat attribute to the current time in milliseconds.
          * Emplace the stateHistory vector with the current state and current time in milliseconds.
+         * @note If a transition table is set, the IDLE command (or TICK in other states) is dispatched through it instead.
+         * @note If an event queue is set, update() never blocks in IDLE.
+         * @note update() does not tick() the clock, so a clock shared by many FSMs advances once per driver tick:
+         * start(), resume() and run() tick it before each update(), FleetRunner::step() once for the whole fleet.
+         * Code calling update() directly ticks the clock itself.
          */
         void update();
 
+        /**
+         * @brief Set the destination of everything the FSM prints.
+         * @param sink SyncSink::standard() (cout, the default), an AsyncSink, NullSink::instance(), or null for the default.
+         * @note The sink is not copied, it must outlive the FSM.
+         */
+        void setLogSink(LogSink *sink);
+
+        /**
+         * @brief Get the destination of everything the FSM prints.
+         */
+        LogSink &getLogSink() const;
+
+        /**
+         * @brief Also record every transition (state, heartbeat, moveCount, errorCount) in a memory-mapped journal.
+         * @param journal An open journal, or null to stop journaling.
+         * @note The journal is not copied, it must outlive the FSM.
+         */
+        void setJournal(Journal *journal);
+
+        /**
+         * @brief Get the journal receiving the transitions, null if disabled.
+         */
+        Journal *getJournal() const;
+
+        /**
+         * @brief Publish every transition into a broadcast ring, read with StateSubscription by other threads.
+         * @param broadcast A broadcast ring, or null to stop publishing.
+         * @note The ring is not copied, it must outlive the FSM. Only this FSM may publish into it.
+         */
+        void setBroadcast(StateBroadcast *broadcast);
+        StateBroadcast *getBroadcast() const;
+
+        /**
+         * @brief Set the time source used for heartbeats and history timestamps.
+         * @param clock SteadyClock::instance() (the default), TscClock for cheap precise reads, CachedClock for one read per tick,
+         * VirtualClock for simulations, ManualClock for deterministic runs, or null for the default.
+         * @note The clock is not copied, it must outlive the FSM.
+         */
+        void setClock(ClockSource *clock);
+
+        /**
+         * @brief Get the time source used for heartbeats and history timestamps.
+         */
+        ClockSource &getClock() const;
+
+        /**
+         * @brief Get the per-state counters: entries, dwell times, transition matrix and handler time histograms.
+         * @note Safe to snapshot() from any thread while the FSM runs.
+         */
+        const FsmStats &getStats() const;
+
+        /**
+         * @brief Set every per-state counter to 0, the current visit starts now.
+         */
+        void resetStats();
+
+        /**
+         * @brief Time every update() with the FSM clock and count it in the handler histogram of the state it started in.
+         * Off by default since it costs two clock reads per update, use a CachedClock or TscClock to keep it cheap.
+         * @note In IDLE without an event queue the time includes waiting for the command on cin.
+         */
+        void setHandlerTiming(bool enabled);
+
+        /**
+         * @brief Write the per-state counters in the Prometheus text format, or as a table if prometheus is false.
+         */
+        void exportStats(ostream &out, bool prometheus = true) const;
+
+        /**
+         * @brief Record every command consumed in IDLE, with its clock time, for a later InputReplayer run.
+         * @param recording The recording to append to, or null to stop recording.
+         */
+        void setInputRecording(InputRecording *recording);
+
+        /**
+         * @brief Replace the handler of a state with a coroutine, started when update() runs in that state.
+         * The coroutine may suspend on sleepMillis(), skipTicks() or nextEvent(), later update() calls resume it
+         * without blocking, so one thread can interleave many FSMs running multi-step actions.
+         * Leaving the state from outside, for example through requestError(), cancels it.
+         * Every update() finding the coroutine still suspended refreshes the heartbeat, so a Watchdog budget
+         * shorter than a sleepMillis() does not fire; a body that never returns to update() still times out.
+         * @param handler The coroutine, for example robot_coroutines::movement, or null to go back to the usual handler.
+         * @note Frames come from the FramePool of this FSM, so the FSM may be updated and destroyed on any thread, one at a time.
+         */
+        void setCoroutineHandler(SystemState state, CoroutineHandler handler);
+
+        /**
+         * @brief Get the pool allocating the frames of the coroutine handlers of this FSM.
+         */
+        FramePool &getFramePool();
+
+        /**
+         * @brief Copy the complete state of the FSM: state, counters, heartbeat, delay, deep history and history entries.
+         * @param snapshot Filled in place, reusing its history storage.
+         * @note The running coroutine handler, if any, is not part of it and restarts after restore().
+         */
+        void capture(FsmSnapshot &snapshot) const;
+
+        /**
+         * @brief Go back to a captured state without running performInit().
+         * The history sequence numbers continue from the captured ones, the stats counters are reset.
+         * @return false, leaving the FSM untouched, if the snapshot fails isValidSnapshot().
+         */
+        bool restore(const FsmSnapshot &snapshot);
+
+        /**
+         * @brief Write a snapshot every everyUpdates calls to update(), for a warm restart with restore() and resume().
+         * Each snapshot rewrites the whole history, see SnapshotFile for the cost.
+         * @param file The double-buffered storage, or null to stop.
+         * @note The file is not copied, it must outlive the FSM.
+         */
+        void setSnapshotFile(SnapshotFile *file, uint32_t everyUpdates = 1);
+
+        /**
+         * @brief Run the loop of start() from the current state, without performInit(), usually after restore().
+         */
+        void resume();
+
+        /**
+         * @brief Use a transition table instead of the perform*() switch in update().
+         * @param table The table to use, for example &TransitionTable::defaultTable(), or null to go back to the switch.
+         * @note The table is not copied, it must outlive the FSM.
+         */
+        void setTransitionTable(const TransitionTable *table);
+
+        /**
+         * @brief Dispatch a whole sequence of events, for replays and simulations.
+         * Runs the same table rules and actions as calling dispatch() on each event, so the states, counters and
+         * history entries are the same, but the clock is read once and every transition of the batch gets that time,
+         * the history reserves room for the batch once, and monitor threads see one publish at the end: the counter
+         * writes of the actions are not published on their own. Only the first transition closes a timed visit in
+         * the stats, the visits both started and left inside the batch count as untimed visits without dwell time.
+         * stress.cpp checks the result against dispatch() on the same events.
+         * @return The number of transitions made.
+         */
+        size_t applyEvents(span<const Event> events);
+
+        /**
+         * @brief Read the IDLE commands from an event queue instead of blocking on cin.
+         * In IDLE, update() then dispatches whatever is pending and returns immediately when the queue is empty,
+         * refreshing lastHeartbeat so heartbeats keep running while the machine waits for an operator.
+         * @param queue The queue to read, fed by any single producer (StdinReader, network, tests), or null to read cin.
+         * @note The queue is not copied, it must outlive the FSM. IDLE commands go through dispatch().
+         */
+        void setEventQueue(EventQueue *queue);
+
+        /**
+         * @brief Get the event queue read in IDLE, null if cin is read.
+         */
+        EventQueue *getEventQueue() const;
+
+        /**
+         * @brief Get the transition table used by update(), null if the switch is used.
+         */
+        const TransitionTable *getTransitionTable() const;
+
+        /**
+         * @brief Apply one event through the transition table.
+         * Looks up [currentState][event], runs its action and transitions if the resulting state differs.
+         * @note Falls back to TransitionTable::defaultTable() when no table is set.
+         */
+        void dispatch(Event event);
+
         /**
          * @brief Print the current status of the FSM.
          * This function prints the current state, last heartbeat time, delay, error count
@@ -165,6 +549,7 @@ class FSM {
          * @brief Print the state history of the FSM.
          * This function prints the state history, showing each state and the time it was entered.
          * It iterates through the stateHistory vector and prints each state and its corresponding time.
+         * If the ring buffer wrapped, the number of overwritten entries is printed as well.
          */
         void printStateHistory();
 
@@ -0,0 +1,144 @@
+#include "hierarchy.hpp"
+
+using namespace std;
+
+using namespace default_actions;
+
+// Konstruktor, hanya root
+StateHierarchy::StateHierarchy() : count(1) {
+    parents[0] = 0;
+    initials[0] = SystemState::INIT;
+    names[0] = "Root";
+    for (size_t s = 0; s < STATE_COUNT; s++) owners[s] = 0;
+}
+
+Superstate StateHierarchy::add(const char *name, SystemState initial, Superstate parent) {
+    if (count == SUPERSTATE_LIMIT || parent >= count) return 0;
+    Superstate id = static_cast<Superstate>(count++);
+    parents[id] = parent;
+    initials[id] = initial;
+    names[id] = name;
+    return id;
+}
+
+void StateHierarchy::place(SystemState state, Superstate superstate) {
+    if (superstate < count) owners[static_cast<size_t>(state)] = superstate;
+}
+
+// Naik dari superstate terdalam sampai root
+bool StateHierarchy::contains(Superstate superstate, SystemState state) const {
+    Superstate s = owner(state);
+    while (true) {
+        if (s == superstate) return true;
+        if (s == 0) return false;
+        s = parents[s];
+    }
+}
+
+Superstate StateHierarchy::parent(Superstate superstate) const { return parents[superstate]; }
+Superstate StateHierarchy::owner(SystemState state) const { return owners[static_cast<size_t>(state)]; }
+SystemState StateHierarchy::initial(Superstate superstate) const { return initials[superstate]; }
+const char *StateHierarchy::name(Superstate superstate) const { return names[superstate]; }
+size_t StateHierarchy::size() const { return count; }
+
+static StateHierarchy buildRobotHierarchy() {
+    StateHierarchy h;
+    Superstate operational = h.add("Operational", SystemState::IDLE);
+    Superstate busy = h.add("Busy", SystemState::MOVEMENT, operational);
+    h.place(SystemState::IDLE, operational);
+    h.place(SystemState::MOVEMENT, busy);
+    h.place(SystemState::SHOOTING, busy);
+    h.place(SystemState::CALCULATION, busy);
+    return h;
+}
+
+const StateHierarchy &StateHierarchy::robot() {
+    static const StateHierarchy hierarchy = buildRobotHierarchy();
+    return hierarchy;
+}
+
+// Konstruktor, semua rule kosong
+HierarchicalTable::HierarchicalTable(const StateHierarchy &h) : hierarchy(h) {
+    Rule empty = {false, SystemState::INIT, 0, nullptr};
+    for (size_t e = 0; e < EVENT_COUNT; e++) {
+        for (size_t s = 0; s < STATE_COUNT; s++) stateRules[s][e] = empty;
+        for (size_t s = 0; s < SUPERSTATE_LIMIT; s++) superRules[s][e] = empty;
+    }
+    for (size_t s = 0; s < STATE_COUNT; s++) activities[s] = nullptr;
+}
+
+void HierarchicalTable::on(SystemState state, Event event, SystemState next, TransitionAction action) {
+    stateRules[static_cast<size_t>(state)][static_cast<size_t>(event)] = {true, next, 0, action};
+}
+
+void HierarchicalTable::on(Superstate superstate, Event event, SystemState next, TransitionAction action) {
+    superRules[superstate][static_cast<size_t>(event)] = {true, next, 0, action};
+}
+
+void HierarchicalTable::resume(SystemState state, Event event, Superstate target, TransitionAction action) {
+    stateRules[static_cast<size_t>(state)][static_cast<size_t>(event)] = {true, hierarchy.initial(target), target, action};
+}
+
+void HierarchicalTable::activity(SystemState state, TransitionAction action) { activities[static_cast<size_t>(state)] = action; }
+
+// Rule state sendiri dulu, lalu superstate dari yang terdalam sampai root
+TransitionTable HierarchicalTable::compile() const {
+    TransitionTable table;
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        SystemState state = static_cast<SystemState>(s);
+        for (size_t e = 0; e < EVENT_COUNT; e++) {
+            const Rule *rule = &stateRules[s][e];
+            for (Superstate super = hierarchy.owner(state); !rule->defined; super = hierarchy.parent(super)) {
+                rule = &superRules[super][e];
+                if (super == 0) break;
+            }
+            if (!rule->defined) continue;
+            Event event = static_cast<Event>(e);
+            table.set(state, event, rule->next, rule->action ? rule->action : activities[s]);
+            if (rule->resume) table.setResume(state, event, rule->resume);
+        }
+        for (size_t t = 0; t < STATE_COUNT; t++) {
+            uint8_t mask = 0;
+            for (Superstate super = 1; super < hierarchy.size(); super++) {
+                if (hierarchy.contains(super, state) && !hierarchy.contains(super, static_cast<SystemState>(t))) mask |= 1 << super;
+            }
+            table.setExits(state, static_cast<SystemState>(t), mask);
+        }
+    }
+    return table;
+}
+
+// ERROR lanjut ke substate yang diinterupsi, kecuali CALCULATION: moveCount masih 0, jadi akan gagal lagi sampai STOPPED
+static SystemState actionErrorResume(FSM &fsm, SystemState next) {
+    return actionError(fsm, next == SystemState::CALCULATION ? SystemState::IDLE : next);
+}
+
+static TransitionTable buildRobotTable() {
+    HierarchicalTable rules(StateHierarchy::robot());
+    for (size_t e = 0; e < EVENT_COUNT; e++) {
+        Event event = static_cast<Event>(e);
+        rules.on(SystemState::INIT, event, SystemState::IDLE);
+        rules.on(BUSY, event, SystemState::IDLE);
+        rules.resume(SystemState::ERROR, event, OPERATIONAL, actionErrorResume);
+        rules.on(SystemState::STOPPED, event, SystemState::STOPPED);
+    }
+    rules.activity(SystemState::INIT, actionInit);
+    rules.activity(SystemState::MOVEMENT, actionMovement);
+    rules.activity(SystemState::SHOOTING, actionShooting);
+    rules.activity(SystemState::CALCULATION, actionCalculation);
+    rules.activity(SystemState::ERROR, actionError);
+    rules.activity(SystemState::STOPPED, actionShutdown);
+    rules.on(SystemState::IDLE, Event::TICK, SystemState::IDLE);
+    rules.on(SystemState::IDLE, Event::STATUS, SystemState::IDLE, actionStatus);
+    rules.on(SystemState::IDLE, Event::MOVE, SystemState::MOVEMENT);
+    rules.on(SystemState::IDLE, Event::SHOOT, SystemState::SHOOTING);
+    rules.on(SystemState::IDLE, Event::CALC, SystemState::CALCULATION);
+    rules.on(SystemState::IDLE, Event::STOP, SystemState::STOPPED);
+    rules.on(SystemState::IDLE, Event::INVALID, SystemState::ERROR, actionInvalid);
+    return rules.compile();
+}
+
+const TransitionTable &HierarchicalTable::robotTable() {
+    static const TransitionTable table = buildRobotTable();
+    return table;
+}
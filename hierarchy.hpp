@@ -0,0 +1,128 @@
+#ifndef HIERARCHY_H_
+#define HIERARCHY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "state.hpp"
+#include "transition_table.hpp"
+
+using namespace std;
+
+/**
+ * @brief Tree of superstates grouping the SystemState values.
+ * Superstate 0 is the root and contains every state, add() creates the others, up to SUPERSTATE_LIMIT.
+ */
+class StateHierarchy {
+
+        private:
+        Superstate parents[SUPERSTATE_LIMIT];           // Enclosing superstate of each superstate
+        SystemState initials[SUPERSTATE_LIMIT];         // Substate entered by a transition targeting the superstate
+        const char *names[SUPERSTATE_LIMIT];
+        Superstate owners[STATE_COUNT];                 // Innermost superstate of each state
+        size_t count;
+
+        public:
+        /**
+         * @brief Create a hierarchy with only the root, every state directly inside it.
+         */
+        StateHierarchy();
+
+        /**
+         * @brief Add a superstate.
+         * @param initial The substate (leaf) entered when a transition targets the superstate.
+         * @return Its index, or 0 if SUPERSTATE_LIMIT is reached.
+         */
+        Superstate add(const char *name, SystemState initial, Superstate parent = 0);
+
+        /**
+         * @brief Put a state directly inside a superstate.
+         */
+        void place(SystemState state, Superstate superstate);
+
+        /**
+         * @brief Check if a state is inside a superstate, at any depth.
+         */
+        bool contains(Superstate superstate, SystemState state) const;
+
+        Superstate parent(Superstate superstate) const;
+        Superstate owner(SystemState state) const;
+        SystemState initial(Superstate superstate) const;
+        const char *name(Superstate superstate) const;
+        size_t size() const;
+
+        /**
+         * @brief Get the hierarchy of the robot, built once:
+         * - Operational (1): IDLE, MOVEMENT, SHOOTING, CALCULATION, initial IDLE
+         * - Busy (2, inside Operational): MOVEMENT, SHOOTING, CALCULATION, initial MOVEMENT
+         * - INIT, ERROR and STOPPED stay in the root
+         */
+        static const StateHierarchy &robot();
+};
+
+const Superstate OPERATIONAL = 1;
+const Superstate BUSY = 2;
+
+/**
+ * @brief Transition rules declared on superstates as well as states, compiled into a flat TransitionTable.
+ * A state handles an event with its own rule if it has one, else with the rule of its innermost superstate
+ * having one, so a transition shared by every substate is declared once. compile() resolves this ahead of time,
+ * FSM::dispatch() stays a single table lookup.
+ */
+class HierarchicalTable {
+
+        private:
+        struct Rule {
+                bool defined;
+                SystemState next;
+                Superstate resume;      // 0 for none, else the superstate whose deep history is resumed
+                TransitionAction action;
+        };
+
+        const StateHierarchy &hierarchy;
+        Rule stateRules[STATE_COUNT][EVENT_COUNT];
+        Rule superRules[SUPERSTATE_LIMIT][EVENT_COUNT];
+        TransitionAction activities[STATE_COUNT];       // Action of the rules of a state that have none
+
+        public:
+        /**
+         * @brief Create an empty rule set, every event keeps the current state.
+         * @note The hierarchy is not copied, it must outlive this object.
+         */
+        explicit HierarchicalTable(const StateHierarchy &hierarchy);
+
+        /**
+         * @brief Declare the transition taken when event is received in state.
+         */
+        void on(SystemState state, Event event, SystemState next, TransitionAction action = nullptr);
+
+        /**
+         * @brief Declare the transition taken when event is received in any state of a superstate without its own rule.
+         */
+        void on(Superstate superstate, Event event, SystemState next, TransitionAction action = nullptr);
+
+        /**
+         * @brief Declare a transition into a superstate: resume its deep history, the substate active when it was
+         * last left, or enter its initial substate the first time.
+         */
+        void resume(SystemState state, Event event, Superstate target, TransitionAction action = nullptr);
+
+        /**
+         * @brief Run action on every transition of state whose rule has no action, like a perform*() handler.
+         */
+        void activity(SystemState state, TransitionAction action);
+
+        /**
+         * @brief Flatten the rules into a dense table, including the superstate exit masks used to record the deep history.
+         */
+        TransitionTable compile() const;
+
+        /**
+         * @brief Get the robot rules declared on StateHierarchy::robot(), compiled once.
+         * Same as TransitionTable::defaultTable() except ERROR resumes the Operational substate it interrupted,
+         * for example a MOVEMENT stopped by the Watchdog. A failed CALCULATION (moveCount 0) goes back to IDLE
+         * as in the default table, retrying it would fail again until errorCount escalates to STOPPED.
+         */
+        static const TransitionTable &robotTable();
+};
+
+#endif // HIERARCHY_H_
@@ -0,0 +1,143 @@
+#include "history.hpp"
+#include <algorithm>
+
+using namespace std;
+
+const HistoryEntry &HistoryView::iterator::operator*() const { return history->bySequence(seq); }
+const HistoryEntry &HistoryView::operator[](size_t i) const { return history->bySequence(first + i); }
+
+StateHistory::StateHistory(size_t cap, pmr::memory_resource *resource) : entries(resource), capacity(cap), head(0), total(0), overwritten(0) {
+    if (capacity > 0) entries.reserve(capacity);
+}
+
+// Tambah entry, timpa yang paling lama jika ring penuh
+void StateHistory::push(SystemState state, uint64_t time) {
+    total++;
+    if (capacity == 0 || entries.size() < capacity) {
+        entries.emplace_back(state, time);
+        return;
+    }
+    entries[head] = HistoryEntry(state, time);
+    overwritten++;
+    head = (head + 1 == capacity) ? 0 : head + 1;
+}
+
+void StateHistory::clear() {
+    entries.clear();
+    head = 0;
+}
+
+// Tetap tumbuh geometrik agar batch kecil yang berulang tidak realokasi setiap kali
+void StateHistory::reserve(size_t extra) {
+    size_t needed = entries.size() + extra;
+    if (capacity == 0 && needed > entries.capacity()) entries.reserve(max(needed, entries.capacity() * 2));
+}
+
+// Isi ulang dari snapshot, entry terlama dibuang jika melebihi kapasitas
+void StateHistory::restore(const vector<HistoryEntry> &source, uint64_t firstSequence, uint64_t dropped) {
+    size_t skip = capacity > 0 && source.size() > capacity ? source.size() - capacity : 0;
+    entries.assign(source.begin() + skip, source.end());
+    head = 0;
+    total = firstSequence + source.size();
+    overwritten = dropped + skip;
+}
+
+size_t StateHistory::size() const { return entries.size(); }
+size_t StateHistory::getCapacity() const { return capacity; }
+uint64_t StateHistory::getOverwritten() const { return overwritten; }
+
+const HistoryEntry &StateHistory::at(size_t i) const {
+    size_t idx = head + i;
+    if (idx >= entries.size()) idx -= entries.size();
+    return entries[idx];
+}
+
+vector<HistoryEntry> StateHistory::toVector() const {
+    vector<HistoryEntry> out;
+    copyTo(out);
+    return out;
+}
+
+// Dua potongan ring, dari head sampai akhir lalu dari awal sampai head
+void StateHistory::copyTo(vector<HistoryEntry> &out) const {
+    out.assign(entries.begin() + head, entries.end());
+    out.insert(out.end(), entries.begin(), entries.begin() + head);
+}
+
+uint64_t StateHistory::firstSequence() const { return total - entries.size(); }
+uint64_t StateHistory::endSequence() const { return total; }
+
+const HistoryEntry &StateHistory::bySequence(uint64_t seq) const {
+    return at(static_cast<size_t>(seq - firstSequence()));
+}
+
+HistoryView StateHistory::view() const {
+    return HistoryView(this, firstSequence(), total);
+}
+
+HistoryView StateHistory::since(uint64_t seq) const {
+    uint64_t first = firstSequence();
+    if (seq < first) seq = first;
+    if (seq > total) seq = total;
+    return HistoryView(this, seq, total);
+}
+
+CompactHistory::CompactHistory(pmr::memory_resource *resource) : states(resource), timeDeltas(resource), lastTime(0) {}
+
+// Simpan state 1 byte dan delta waktu sebagai zigzag varint
+void CompactHistory::push(SystemState state, uint64_t time) {
+    int64_t delta = static_cast<int64_t>(time - lastTime);
+    uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+    while (zigzag >= 0x80) {
+        timeDeltas.push_back(static_cast<uint8_t>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    timeDeltas.push_back(static_cast<uint8_t>(zigzag));
+    states.push_back(static_cast<uint8_t>(state));
+    lastTime = time;
+}
+
+void CompactHistory::clear() {
+    states.clear();
+    timeDeltas.clear();
+    lastTime = 0;
+}
+
+size_t CompactHistory::size() const { return states.size(); }
+CompactHistory::Cursor CompactHistory::cursor() const { return Cursor(this); }
+
+vector<HistoryEntry> CompactHistory::toVector() const {
+    vector<HistoryEntry> out;
+    out.reserve(states.size());
+    Cursor c(this);
+    HistoryEntry entry;
+    while (c.next(entry)) out.push_back(entry);
+    return out;
+}
+
+HistoryFootprint CompactHistory::footprint() const {
+    HistoryFootprint fp;
+    fp.entries = states.size();
+    fp.pairBytes = states.size() * sizeof(HistoryEntry);
+    fp.compactBytes = states.size() + timeDeltas.size();
+    return fp;
+}
+
+CompactHistory::Cursor::Cursor(const CompactHistory *h) : history(h), index(0), offset(0), time(0) {}
+
+// Decode satu entry, false jika sudah habis
+bool CompactHistory::Cursor::next(HistoryEntry &entry) {
+    if (index >= history->states.size()) return false;
+    uint64_t zigzag = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = history->timeDeltas[offset++];
+        zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    time += static_cast<uint64_t>(delta);
+    entry = HistoryEntry(static_cast<SystemState>(history->states[index++]), time);
+    return true;
+}
@@ -0,0 +1,271 @@
+#ifndef HISTORY_H_
+#define HISTORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "state.hpp"
+
+using namespace std;
+
+/**
+ * @brief State entered and the time it was entered, in nanoseconds of the FSM clock.
+ */
+typedef pair<SystemState, uint64_t> HistoryEntry;
+
+enum class HistoryMode : uint8_t {
+        FULL,           // StateHistory entries, unbounded or ring buffer
+        COMPACT         // CompactHistory packed encoding, unbounded
+};
+
+const uint64_t NANOS_PER_MILLI = 1000000;
+
+class StateHistory;
+
+/**
+ * @brief Non-owning, read-only range over a StateHistory.
+ * Every entry pushed into a history gets a sequence number (0 for the first entry ever pushed),
+ * a view covers the sequence range [firstSequence(), endSequence()).
+ * @note The view does not copy anything, it is valid as long as the history is not modified.
+ * Store endSequence() and pass it to since() on the next poll to only read the new entries.
+ */
+class HistoryView {
+
+        private:
+        const StateHistory *history;    // History being viewed
+        uint64_t first;                 // Sequence number of the first entry in the view
+        uint64_t last;                  // Sequence number one past the last entry in the view
+
+        public:
+        class iterator {
+                private:
+                const StateHistory *history;
+                uint64_t seq;
+
+                public:
+                typedef ptrdiff_t difference_type;
+                typedef HistoryEntry value_type;
+                typedef const HistoryEntry *pointer;
+                typedef const HistoryEntry &reference;
+                typedef forward_iterator_tag iterator_category;
+
+                iterator(const StateHistory *history, uint64_t seq) : history(history), seq(seq) {}
+                reference operator*() const;
+                pointer operator->() const { return &**this; }
+                iterator &operator++() { seq++; return *this; }
+                iterator operator++(int) { iterator tmp = *this; seq++; return tmp; }
+                bool operator==(const iterator &other) const { return seq == other.seq; }
+                bool operator!=(const iterator &other) const { return seq != other.seq; }
+
+                /**
+                 * @brief Get the sequence number of the entry the iterator points to.
+                 */
+                uint64_t sequence() const { return seq; }
+        };
+
+        HistoryView(const StateHistory *history, uint64_t first, uint64_t last) : history(history), first(first), last(last) {}
+
+        iterator begin() const { return iterator(history, first); }
+        iterator end() const { return iterator(history, last); }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+
+        /**
+         * @brief Get the i-th entry of the view, 0 being the oldest.
+         */
+        const HistoryEntry &operator[](size_t i) const;
+
+        uint64_t firstSequence() const { return first; }
+        uint64_t endSequence() const { return last; }
+};
+
+class StateHistory {
+
+        private:
+        pmr::vector<HistoryEntry> entries;      // Storage, preallocated to capacity when bounded
+        size_t capacity;                // Maximum number of entries kept, 0 means unbounded
+        size_t head;                    // Index of the oldest entry once the ring is full
+        uint64_t total;                 // Number of entries ever pushed, also the next sequence number
+        uint64_t overwritten;           // Number of entries dropped because the ring was full
+
+        public:
+        /**
+         * @brief Create a state history.
+         * @param capacity Maximum number of entries to keep. 0 keeps every entry (unbounded vector),
+         * any other value turns the history into a fixed-size ring buffer preallocated up front.
+         * @param resource Memory resource of the entries, for example a monotonic arena shared by many histories.
+         * @note The resource is not copied, it must outlive the history.
+         */
+        explicit StateHistory(size_t capacity = 0, pmr::memory_resource *resource = pmr::get_default_resource());
+
+        /**
+         * @brief Append a state and its time to the history.
+         * @note In ring mode the oldest entry is overwritten once the ring is full, no allocation is done.
+         */
+        void push(SystemState state, uint64_t timeNs);
+
+        /**
+         * @brief Remove every entry, the preallocated storage, the sequence numbers and the overwritten count are kept.
+         */
+        void clear();
+
+        /**
+         * @brief Get the number of entries currently stored.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get the ring capacity, 0 if the history is unbounded.
+         */
+        size_t getCapacity() const;
+
+        /**
+         * @brief Get the number of entries dropped because the ring was full.
+         */
+        uint64_t getOverwritten() const;
+
+        /**
+         * @brief Get the i-th stored entry, 0 being the oldest.
+         */
+        const HistoryEntry &at(size_t i) const;
+
+        /**
+         * @brief Make room for extra more entries without reallocating, nothing to do in ring mode.
+         */
+        void reserve(size_t extra);
+
+        /**
+         * @brief Replace the content of the history, for a restored snapshot.
+         * @param firstSequence Sequence number of the first entry, later pushes continue after the last one.
+         * @note With a capacity, only the newest entries that fit are kept and the others count as overwritten.
+         */
+        void restore(const vector<HistoryEntry> &entries, uint64_t firstSequence, uint64_t overwritten);
+
+        /**
+         * @brief Copy the stored entries, oldest first, into a vector.
+         */
+        vector<HistoryEntry> toVector() const;
+
+        /**
+         * @brief Copy the stored entries, oldest first, into out, reusing its storage.
+         */
+        void copyTo(vector<HistoryEntry> &out) const;
+
+        /**
+         * @brief Get the sequence number of the oldest stored entry.
+         */
+        uint64_t firstSequence() const;
+
+        /**
+         * @brief Get the sequence number the next pushed entry will get.
+         */
+        uint64_t endSequence() const;
+
+        /**
+         * @brief Get the stored entry with the given sequence number.
+         * @note seq must be in [firstSequence(), endSequence()).
+         */
+        const HistoryEntry &bySequence(uint64_t seq) const;
+
+        /**
+         * @brief Get a view over every stored entry without copying.
+         */
+        HistoryView view() const;
+
+        /**
+         * @brief Get a view over the entries whose sequence number is at least seq.
+         * @note If seq is older than the oldest stored entry the view starts at firstSequence(),
+         * a caller can compare the two to find out how many entries it missed.
+         */
+        HistoryView since(uint64_t seq) const;
+};
+
+/**
+ * @brief Memory used by a history, in bytes.
+ */
+struct HistoryFootprint {
+        size_t entries;                 // Number of entries stored
+        size_t pairBytes;               // Bytes needed to store them as HistoryEntry
+        size_t compactBytes;            // Bytes used by the compact encoding
+};
+
+/**
+ * @brief Append-only, packed encoding of a state history.
+ * States are stored one byte each, times are stored as zigzag varint deltas from the previous entry,
+ * so a typical entry takes 3 to 5 bytes instead of sizeof(HistoryEntry).
+ * @note Entries can only be decoded sequentially, use a Cursor or toVector().
+ */
+class CompactHistory {
+
+        private:
+        pmr::vector<uint8_t> states;            // One byte per entry
+        pmr::vector<uint8_t> timeDeltas;        // Varint stream of zigzag encoded time deltas
+        uint64_t lastTime;              // Time of the last appended entry
+
+        public:
+        /**
+         * @brief Sequential decoder over a CompactHistory.
+         */
+        class Cursor {
+                private:
+                const CompactHistory *history;
+                size_t index;           // Index of the next entry to decode
+                size_t offset;          // Offset of the next delta in timeDeltas
+                uint64_t time;          // Time of the last decoded entry
+
+                public:
+                explicit Cursor(const CompactHistory *history);
+
+                /**
+                 * @brief Decode the next entry.
+                 * @return false once every entry has been decoded.
+                 */
+                bool next(HistoryEntry &entry);
+        };
+
+        /**
+         * @brief Create an empty history.
+         * @param resource Memory resource of the encoded entries, it must outlive the history.
+         */
+        explicit CompactHistory(pmr::memory_resource *resource = pmr::get_default_resource());
+
+        /**
+         * @brief Append a state and its time in nanoseconds.
+         */
+        void push(SystemState state, uint64_t timeNs);
+
+        /**
+         * @brief Remove every entry.
+         */
+        void clear();
+
+        /**
+         * @brief Get the number of entries stored.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get a decoder positioned on the oldest entry.
+         */
+        Cursor cursor() const;
+
+        /**
+         * @brief Get the time of the newest entry, 0 if the history is empty.
+         */
+        uint64_t getLastTime() const { return lastTime; }
+
+        /**
+         * @brief Decode every entry, oldest first.
+         */
+        vector<HistoryEntry> toVector() const;
+
+        /**
+         * @brief Compare the memory used by this encoding with the pair layout.
+         */
+        HistoryFootprint footprint() const;
+};
+
+#endif // HISTORY_H_
@@ -0,0 +1,182 @@
+#include "journal.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char JOURNAL_MAGIC[8] = {'F', 'S', 'M', 'J', 'R', 'N', 'L', '\0'};
+static const uint32_t JOURNAL_VERSION = 2;
+
+uint32_t journalChecksum(const JournalBlock &block) {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(block.records);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(block.records); i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t journalBytes(size_t blocks) {
+    return sizeof(JournalHeader) + blocks * sizeof(JournalBlock);
+}
+
+Journal::Journal() : fd(-1), base(nullptr), mappedBlocks(0), header(nullptr), current(nullptr), nextSequence(0) {}
+Journal::~Journal() { close(); }
+
+bool Journal::isOpen() const { return base != nullptr; }
+uint64_t Journal::size() const { return nextSequence; }
+
+// Perbesar file lalu map ulang
+bool Journal::map(size_t blocks) {
+    if (ftruncate(fd, static_cast<off_t>(journalBytes(blocks))) != 0) return false;
+    void *p = mmap(nullptr, journalBytes(blocks), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<uint8_t *>(p);
+    mappedBlocks = blocks;
+    header = reinterpret_cast<JournalHeader *>(base);
+    return true;
+}
+
+void Journal::unmap() {
+    if (base) munmap(base, journalBytes(mappedBlocks));
+    base = nullptr;
+    header = nullptr;
+    current = nullptr;
+}
+
+bool Journal::open(const string &path, size_t initialBlocks) {
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(); return false; }
+
+    if (static_cast<size_t>(st.st_size) < sizeof(JournalHeader)) {
+        // File baru
+        if (!map(initialBlocks > 0 ? initialBlocks : 1)) { close(); return false; }
+        memset(header, 0, sizeof(JournalHeader));
+        memcpy(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header->version = JOURNAL_VERSION;
+        header->recordSize = sizeof(JournalRecord);
+        header->recordsPerBlock = JOURNAL_RECORDS_PER_BLOCK;
+        header->blockSize = sizeof(JournalBlock);
+        header->blockCount = 1;
+        current = blockAt(0);
+        memset(current, 0, sizeof(JournalBlock));
+        nextSequence = 0;
+        return true;
+    }
+
+    // Lanjutkan file yang sudah ada
+    size_t blocks = (static_cast<size_t>(st.st_size) - sizeof(JournalHeader)) / sizeof(JournalBlock);
+    if (blocks == 0 || !map(blocks)) { close(); return false; }
+    if (memcmp(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header->version != JOURNAL_VERSION ||
+        header->recordSize != sizeof(JournalRecord) || header->blockSize != sizeof(JournalBlock) ||
+        header->blockCount == 0 || header->blockCount > blocks) {
+        close();
+        return false;
+    }
+    current = blockAt(header->blockCount - 1);
+    if (current->count > JOURNAL_RECORDS_PER_BLOCK) { close(); return false; }
+    nextSequence = (header->blockCount - 1) * JOURNAL_RECORDS_PER_BLOCK + current->count;
+    return true;
+}
+
+void Journal::close() {
+    unmap();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    mappedBlocks = 0;
+    nextSequence = 0;
+}
+
+JournalBlock *Journal::blockAt(uint64_t i) const {
+    return reinterpret_cast<JournalBlock *>(base + sizeof(JournalHeader)) + i;
+}
+
+// Gandakan ukuran file, journal ditutup jika gagal
+bool Journal::grow() {
+    size_t blocks = mappedBlocks;
+    uint64_t used = header->blockCount;
+    unmap();
+    if (!map(blocks * 2)) {
+        close();
+        return false;
+    }
+    current = blockAt(used - 1);
+    return true;
+}
+
+// Tulis record langsung ke mapping, checksum dihitung saat blok penuh
+void Journal::append(SystemState state, uint64_t timestamp, int32_t moveCount, int32_t errorCount) {
+    if (!base) return;
+    if (current->count == JOURNAL_RECORDS_PER_BLOCK) {
+        if (header->blockCount == mappedBlocks && !grow()) return;
+        header->blockCount++;
+        current = blockAt(header->blockCount - 1);
+        memset(current, 0, sizeof(JournalBlock));
+    }
+    JournalRecord &r = current->records[current->count];
+    r.sequence = nextSequence++;
+    r.timestamp = timestamp;
+    r.moveCount = moveCount;
+    r.errorCount = errorCount;
+    r.state = static_cast<uint8_t>(state);
+    memset(r.reserved, 0, sizeof(r.reserved));
+    current->count++;
+    if (current->count == JOURNAL_RECORDS_PER_BLOCK) current->checksum = journalChecksum(*current);
+}
+
+void Journal::sync() {
+    if (base) msync(base, journalBytes(mappedBlocks), MS_ASYNC);
+}
+
+JournalReader::JournalReader() : fd(-1), base(nullptr), length(0), header(nullptr) {}
+JournalReader::~JournalReader() { close(); }
+
+bool JournalReader::open(const string &path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalHeader)) { close(); return false; }
+    length = static_cast<size_t>(st.st_size);
+    void *p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) { base = nullptr; close(); return false; }
+    base = static_cast<const uint8_t *>(p);
+    header = reinterpret_cast<const JournalHeader *>(base);
+    size_t blocks = (length - sizeof(JournalHeader)) / sizeof(JournalBlock);
+    if (memcmp(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header->version != JOURNAL_VERSION ||
+        header->recordSize != sizeof(JournalRecord) || header->blockSize != sizeof(JournalBlock) ||
+        header->blockCount > blocks) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void JournalReader::close() {
+    if (base) munmap(const_cast<uint8_t *>(base), length);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    base = nullptr;
+    header = nullptr;
+    length = 0;
+}
+
+size_t JournalReader::blockCount() const { return header ? static_cast<size_t>(header->blockCount) : 0; }
+
+const JournalBlock &JournalReader::block(size_t i) const {
+    return reinterpret_cast<const JournalBlock *>(base + sizeof(JournalHeader))[i];
+}
+
+bool JournalReader::verify(size_t i) const {
+    const JournalBlock &blk = block(i);
+    if (blk.count < JOURNAL_RECORDS_PER_BLOCK) return i + 1 == blockCount();
+    if (blk.count > JOURNAL_RECORDS_PER_BLOCK) return false;
+    return blk.checksum == journalChecksum(blk);
+}
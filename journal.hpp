@@ -0,0 +1,170 @@
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "state.hpp"
+
+using namespace std;
+
+/**
+ * @brief One transition as stored in a journal file.
+ */
+struct JournalRecord {
+        uint64_t sequence;              // Index of the record since the journal was created
+        uint64_t timestamp;             // Time of the transition, in nanoseconds of the FSM clock
+        int32_t moveCount;              // moveCount right after the transition
+        int32_t errorCount;             // errorCount right after the transition
+        uint8_t state;                  // SystemState entered
+        uint8_t reserved[7];
+};
+
+const size_t JOURNAL_RECORDS_PER_BLOCK = 64;
+
+/**
+ * @brief Fixed-size group of records, the checksum is written once the block is full.
+ */
+struct JournalBlock {
+        uint32_t count;                 // Records used in this block
+        uint32_t checksum;              // FNV-1a of the records, valid once count == JOURNAL_RECORDS_PER_BLOCK
+        uint64_t reserved;
+        JournalRecord records[JOURNAL_RECORDS_PER_BLOCK];
+};
+
+/**
+ * @brief Fixed header at the start of a journal file.
+ */
+struct JournalHeader {
+        char magic[8];                  // "FSMJRNL\0"
+        uint32_t version;
+        uint32_t recordSize;            // sizeof(JournalRecord), checked by the reader
+        uint32_t recordsPerBlock;       // JOURNAL_RECORDS_PER_BLOCK
+        uint32_t blockSize;             // sizeof(JournalBlock)
+        uint64_t blockCount;            // Blocks in use, the last one may be partial
+        uint64_t reserved[4];
+};
+
+/**
+ * @brief Compute the checksum of the records of a block.
+ */
+uint32_t journalChecksum(const JournalBlock &block);
+
+/**
+ * @brief Append-only binary transition journal in a memory-mapped file.
+ * append() is a plain store into the mapping: no system call and no formatting on the hot path,
+ * the kernel writes the dirty pages back on its own, so records written before a crash of the process survive it.
+ * The file grows by doubling its mapped size when full, each block gets its checksum when it fills up.
+ * @note If the file cannot grow, the journal closes itself and drops the next records.
+ */
+class Journal {
+
+        private:
+        int fd;
+        uint8_t *base;                  // Start of the mapping
+        size_t mappedBlocks;            // Blocks that fit in the mapping
+        JournalHeader *header;
+        JournalBlock *current;          // Block receiving the next record
+        uint64_t nextSequence;
+
+        bool map(size_t blocks);
+        void unmap();
+        bool grow();
+        JournalBlock *blockAt(uint64_t i) const;
+
+        public:
+        Journal();
+        ~Journal();
+
+        Journal(const Journal &) = delete;
+        Journal &operator=(const Journal &) = delete;
+
+        /**
+         * @brief Open a journal file, creating it or continuing after its last record.
+         * @param initialBlocks Blocks mapped up front for a new file.
+         * @return false if the file cannot be created, mapped, or is not a journal.
+         */
+        bool open(const string &path, size_t initialBlocks = 1024);
+
+        /**
+         * @brief Seal the current block if full, unmap and close the file.
+         */
+        void close();
+
+        bool isOpen() const;
+
+        /**
+         * @brief Append one transition.
+         */
+        void append(SystemState state, uint64_t timestampNs, int32_t moveCount, int32_t errorCount);
+
+        /**
+         * @brief Ask the kernel to start writing the dirty pages back (msync MS_ASYNC), never blocks on I/O.
+         */
+        void sync();
+
+        /**
+         * @brief Get the number of records appended since the file was created.
+         */
+        uint64_t size() const;
+};
+
+/**
+ * @brief Read-only, zero-copy view of a journal file.
+ */
+class JournalReader {
+
+        private:
+        int fd;
+        const uint8_t *base;
+        size_t length;
+        const JournalHeader *header;
+
+        public:
+        JournalReader();
+        ~JournalReader();
+
+        JournalReader(const JournalReader &) = delete;
+        JournalReader &operator=(const JournalReader &) = delete;
+
+        /**
+         * @brief Map a journal file read-only.
+         * @return false if the file cannot be mapped or its header does not match this build.
+         */
+        bool open(const string &path);
+        void close();
+
+        /**
+         * @brief Get the number of blocks in use, the last one may be partial.
+         */
+        size_t blockCount() const;
+
+        /**
+         * @brief Get a block directly from the mapping.
+         */
+        const JournalBlock &block(size_t i) const;
+
+        /**
+         * @brief Check the checksum of a full block.
+         * @return true if the block is full and its checksum matches, or if it is the partial last block.
+         */
+        bool verify(size_t i) const;
+
+        /**
+         * @brief Call fn(const JournalRecord &) on every record in order, without copying.
+         * @return The number of full blocks whose checksum did not match.
+         */
+        template <class Fn>
+        size_t forEach(Fn fn) const {
+                size_t corrupt = 0;
+                for (size_t b = 0; b < blockCount(); b++) {
+                        const JournalBlock &blk = block(b);
+                        if (!verify(b)) corrupt++;
+                        uint32_t n = blk.count < JOURNAL_RECORDS_PER_BLOCK ? blk.count : JOURNAL_RECORDS_PER_BLOCK;
+                        for (uint32_t r = 0; r < n; r++) fn(blk.records[r]);
+                }
+                return corrupt;
+        }
+};
+
+#endif // JOURNAL_H_
@@ -0,0 +1,50 @@
+#include "journal.hpp"
+#include "analytics.hpp"
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// Baca journal hasil FSM::setJournal() tanpa menyalin record
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <journal file> [--summary]" << endl;
+        cerr << "       " << argv[0] << " --analytics <journal file>..." << endl;
+        return 1;
+    }
+
+    // --analytics: statistik gabungan banyak journal, dihitung paralel
+    if (strcmp(argv[1], "--analytics") == 0) {
+        vector<string> paths(argv + 2, argv + argc);
+        AnalyticsReport report = analyzeJournals(paths);
+        printReport(cout, report);
+        return report.corruptBlocks == 0 ? 0 : 2;
+    }
+    JournalReader reader;
+    if (!reader.open(argv[1])) {
+        cerr << "Cannot open journal " << argv[1] << endl;
+        return 1;
+    }
+    bool summary = argc > 2 && strcmp(argv[2], "--summary") == 0;
+
+    uint64_t records = 0;
+    uint64_t perState[STATE_COUNT] = {};
+    uint64_t first = 0, last = 0;
+    size_t corrupt = reader.forEach([&](const JournalRecord &r) {
+        if (records == 0) first = r.timestamp;
+        last = r.timestamp;
+        records++;
+        if (r.state < STATE_COUNT) perState[r.state]++;
+        if (!summary) {
+            cout << r.sequence << " State=" << static_cast<int>(r.state) << " Time=" << r.timestamp << "ns"
+                 << " MoveCount=" << r.moveCount << " Errors=" << r.errorCount << "\n";
+        }
+    });
+
+    cout << "[Journal] Blocks=" << reader.blockCount() << " Records=" << records
+         << " CorruptBlocks=" << corrupt << " Span=" << (last - first) / 1000000 << "ms" << endl;
+    cout << "[Journal] Entries per state:";
+    for (size_t s = 0; s < STATE_COUNT; s++) cout << " " << s << "=" << perState[s];
+    cout << endl;
+    return corrupt == 0 ? 0 : 2;
+}
@@ -0,0 +1,158 @@
+#include "log_sink.hpp"
+#include "format.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+SyncSink::SyncSink(ostream &o) : out(o) {}
+
+void SyncSink::write(const char *data, size_t len) {
+    out.write(data, static_cast<streamsize>(len));
+    out.flush();
+}
+
+void SyncSink::flush() { out.flush(); }
+
+SyncSink &SyncSink::standard() {
+    static SyncSink sink(cout);
+    return sink;
+}
+
+NullSink &NullSink::instance() {
+    static NullSink sink;
+    return sink;
+}
+
+AsyncSink::AsyncSink(ostream &o, size_t capacity, uint32_t flushIntervalMs)
+    : out(o), tail(0), head(0), written(0), dropped(0), running(true), interval(flushIntervalMs) {
+    size_t n = 2;
+    while (n < capacity) n <<= 1;
+    slots.reset(new Slot[n]);
+    mask = n - 1;
+    for (size_t i = 0; i < n; i++) slots[i].sequence.store(i, memory_order_relaxed);
+    batch.reserve(n * SLOT_BYTES);
+    worker = thread(&AsyncSink::run, this);
+}
+
+AsyncSink::~AsyncSink() {
+    running.store(false);
+    worker.join();
+    drain();
+}
+
+// Satu record per write, hanya teks yang lebih besar dari seluruh ring yang dipecah
+void AsyncSink::write(const char *data, size_t len) {
+    size_t most = (mask + 1) * SLOT_BYTES;
+    while (len > 0) {
+        size_t part = len < most ? len : most;
+        push(data, part);
+        data += part;
+        len -= part;
+    }
+}
+
+// Klaim semua slot record dengan satu CAS pada tail, tanpa lock, jadi record panjang tidak diselingi writer lain
+void AsyncSink::push(const char *data, size_t len) {
+    size_t count = (len + SLOT_BYTES - 1) / SLOT_BYTES;
+    size_t pos = tail.load(memory_order_relaxed);
+    while (true) {
+        size_t ready = 0;
+        intptr_t diff = 0;
+        while (ready < count) {
+            size_t seq = slots[(pos + ready) & mask].sequence.load(memory_order_acquire);
+            diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + ready);
+            if (diff != 0) break;
+            ready++;
+        }
+        if (ready == count) {
+            if (tail.compare_exchange_weak(pos, pos + count, memory_order_relaxed)) {
+                for (size_t i = 0; i < count; i++) {
+                    Slot &slot = slots[(pos + i) & mask];
+                    size_t chunk = len < SLOT_BYTES ? len : SLOT_BYTES;
+                    memcpy(slot.data, data, chunk);
+                    slot.len = static_cast<uint32_t>(chunk);
+                    slot.sequence.store(pos + i + 1, memory_order_release);
+                    data += chunk;
+                    len -= chunk;
+                }
+                return;
+            }
+        } else if (diff < 0) {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return;
+        } else {
+            pos = tail.load(memory_order_relaxed);
+        }
+    }
+}
+
+// Ambil semua record yang siap, lalu tulis sekali
+void AsyncSink::drain() {
+    while (true) {
+        Slot &slot = slots[head & mask];
+        if (slot.sequence.load(memory_order_acquire) != head + 1) break;
+        batch.append(slot.data, slot.len);
+        slot.sequence.store(head + mask + 1, memory_order_release);
+        head++;
+    }
+    if (!batch.empty()) {
+        out.write(batch.data(), static_cast<streamsize>(batch.size()));
+        out.flush();
+        batch.clear();
+    }
+    written.store(head, memory_order_release);
+}
+
+void AsyncSink::run() {
+    while (running.load()) {
+        this_thread::sleep_for(interval);
+        drain();
+    }
+}
+
+void AsyncSink::flush() {
+    size_t target = tail.load(memory_order_acquire);
+    while (written.load(memory_order_acquire) < target) this_thread::sleep_for(chrono::microseconds(100));
+}
+
+uint64_t AsyncSink::getDropped() const { return dropped.load(); }
+
+LogLine::LogLine(LogSink &s) : sink(s), len(0) {}
+LogLine::~LogLine() { flush(); }
+
+void LogLine::flush() {
+    if (len > 0) sink.write(buffer, len);
+    len = 0;
+}
+
+// Satu memcpy per teks, bukan satu cabang per karakter
+LogLine &LogLine::operator<<(const char *text) { return write(text, strlen(text)); }
+
+LogLine &LogLine::operator<<(char c) {
+    if (len == sizeof(buffer)) flush();
+    buffer[len++] = c;
+    return *this;
+}
+
+LogLine &LogLine::operator<<(int64_t value) {
+    char digits[24];
+    return write(digits, formatDecimal(digits, value));
+}
+
+LogLine &LogLine::operator<<(uint64_t value) {
+    char digits[24];
+    return write(digits, formatDecimal(digits, value));
+}
+
+LogLine &LogLine::write(const char *text, size_t length) {
+    if (len + length > sizeof(buffer)) flush();
+    if (length > sizeof(buffer)) {
+        sink.write(text, length);
+        return *this;
+    }
+    memcpy(buffer + len, text, length);
+    len += length;
+    return *this;
+}
@@ -0,0 +1,160 @@
+#ifndef LOG_SINK_H_
+#define LOG_SINK_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Destination of the text printed by the FSM handlers.
+ */
+class LogSink {
+        public:
+        virtual ~LogSink() {}
+
+        /**
+         * @brief Write already formatted text.
+         * @note Must not block for long, it is called from the control loop.
+         */
+        virtual void write(const char *data, size_t len) = 0;
+
+        /**
+         * @brief Make sure everything written so far reaches its destination.
+         */
+        virtual void flush() {}
+};
+
+/**
+ * @brief Writes directly to an ostream and flushes after every write, like the original cout/endl output.
+ * @note This is the default sink of the FSM, use it for debugging and interactive runs.
+ */
+class SyncSink : public LogSink {
+
+        private:
+        ostream &out;
+
+        public:
+        explicit SyncSink(ostream &out);
+        void write(const char *data, size_t len) override;
+        void flush() override;
+
+        /**
+         * @brief Get the shared sink writing to cout.
+         */
+        static SyncSink &standard();
+};
+
+/**
+ * @brief Drops everything, used by benchmarks to run the handlers without I/O.
+ */
+class NullSink : public LogSink {
+        public:
+        void write(const char *, size_t) override {}
+
+        /**
+         * @brief Get the shared null sink.
+         */
+        static NullSink &instance();
+};
+
+/**
+ * @brief Asynchronous sink: writers push records into a lock-free ring and return immediately,
+ * a background thread drains the ring and writes the batch to the ostream once per flush interval.
+ * The ring accepts several writer threads (bounded MPMC sequence ring). Each write() claims every slot it
+ * needs in one reservation, so its text stays contiguous in the output next to the other writers, up to
+ * the size of the whole ring (capacity * 116 bytes). A full ring drops the write and counts it instead of
+ * blocking the control loop.
+ */
+class AsyncSink : public LogSink {
+
+        private:
+        static const size_t SLOT_BYTES = 116;
+
+        struct alignas(128) Slot {
+                atomic<size_t> sequence;        // Ring position this slot is ready for
+                uint32_t len;
+                char data[SLOT_BYTES];
+        };
+
+        ostream &out;
+        unique_ptr<Slot[]> slots;
+        size_t mask;                            // Number of slots minus one
+        alignas(64) atomic<size_t> tail;        // Next position to write, shared by the writers
+        alignas(64) size_t head;                // Next position to read, owned by the background thread
+        atomic<size_t> written;                 // Positions before this one reached the ostream
+        atomic<uint64_t> dropped;               // Records dropped because the ring was full
+        atomic<bool> running;
+        chrono::milliseconds interval;
+        string batch;                           // Output gathered for the next write, reserved once
+        thread worker;
+
+        void push(const char *data, size_t len);
+        void drain();
+        void run();
+
+        public:
+        /**
+         * @brief Create the sink and start its background thread.
+         * @param capacity Number of ring slots, rounded up to a power of two, each slot holds up to 116 bytes.
+         * @param flushIntervalMs Time between two writes to out.
+         */
+        explicit AsyncSink(ostream &out, size_t capacity = 4096, uint32_t flushIntervalMs = 10);
+
+        /**
+         * @brief Stop the background thread after writing everything still in the ring.
+         */
+        ~AsyncSink();
+
+        void write(const char *data, size_t len) override;
+
+        /**
+         * @brief Wait until the background thread wrote every record pushed so far.
+         */
+        void flush() override;
+
+        /**
+         * @brief Get the number of writes dropped because the ring was full.
+         */
+        uint64_t getDropped() const;
+};
+
+/**
+ * @brief Small fixed buffer formatting one line of output, written to a sink when full or destroyed.
+ */
+class LogLine {
+
+        private:
+        LogSink &sink;
+        char buffer[256];
+        size_t len;
+
+        public:
+        explicit LogLine(LogSink &sink);
+        ~LogLine();
+
+        LogLine &operator<<(const char *text);
+        LogLine &operator<<(char c);
+        LogLine &operator<<(int64_t value);
+        LogLine &operator<<(uint64_t value);
+        LogLine &operator<<(int value) { return *this << static_cast<int64_t>(value); }
+        LogLine &operator<<(uint32_t value) { return *this << static_cast<uint64_t>(value); }
+
+        /**
+         * @brief Append length bytes, text longer than the buffer goes to the sink in one write.
+         */
+        LogLine &write(const char *text, size_t length);
+
+        /**
+         * @brief Write the buffered text to the sink.
+         */
+        void flush();
+};
+
+#endif // LOG_SINK_H_
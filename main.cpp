@@ -1,11 +1,104 @@
 #include "fsm.hpp"
+#include "command_server.hpp"
+#include <cstdlib>
+#include <cstring>
 
 using namespace std;
 
-int main() {
+// Command dari thread StdinReader: IDLE tidak pernah blocking, heartbeat dan watchdog tetap jalan
+static void runInteractive(FSM &fsm) {
+    EventQueue queue;
+    StdinReader reader(queue);
+    fsm.setEventQueue(&queue);
+    while (fsm.getCurrentState() != SystemState::STOPPED) {
+        fsm.getClock().tick();
+        fsm.update();
+        if (fsm.getCurrentState() != SystemState::IDLE || !queue.empty()) continue;
+        // EOF dibaca sebagai command 0, sama seperti cin >> cmd yang gagal
+        if (reader.isFinished()) queue.push(Event::INVALID);
+        else this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    fsm.shutdown();
+    fsm.setEventQueue(nullptr);
+}
+
+int main(int argc, char **argv) {
+
+    // --config <file>: cold start dari config blob, tanpa init interaktif
+    if (argc >= 3 && strcmp(argv[1], "--config") == 0) {
+        FsmConfig config;
+        if (!loadConfig(argv[2], config)) {
+            cerr << "Cannot read config " << argv[2] << endl;
+            return 1;
+        }
+        FSM configured(config);
+        configured.start();
+        return 0;
+    }
+
+    // --save-config <file>: tulis config robot default sebagai titik awal untuk --config
+    if (argc >= 3 && strcmp(argv[1], "--save-config") == 0) {
+        if (!saveConfig(argv[2], ROBOT_CONFIG)) {
+            cerr << "Cannot write config " << argv[2] << endl;
+            return 1;
+        }
+        return 0;
+    }
 
     FSM robotFSM(2000);
-    robotFSM.start();
+
+    // --record <file>: jalankan interaktif dan simpan semua command
+    if (argc >= 3 && strcmp(argv[1], "--record") == 0) {
+        InputRecording recording;
+        robotFSM.setInputRecording(&recording);
+        runInteractive(robotFSM);
+        if (!recording.save(argv[2])) cerr << "Cannot write recording " << argv[2] << endl;
+        return 0;
+    }
+
+    // --replay <file> [--realtime]: jalankan ulang command yang direkam
+    if (argc >= 3 && strcmp(argv[1], "--replay") == 0) {
+        InputRecording recording;
+        if (!recording.load(argv[2])) {
+            cerr << "Cannot read recording " << argv[2] << endl;
+            return 1;
+        }
+        bool realTime = argc >= 4 && strcmp(argv[3], "--realtime") == 0;
+        InputReplayer replayer(recording, realTime ? ReplayPace::REAL_TIME : ReplayPace::FULL_SPEED);
+        replayer.run(robotFSM);
+        return 0;
+    }
+
+    // --snapshot <file>: lanjutkan dari snapshot terakhir jika ada, lalu simpan snapshot setiap update
+    if (argc >= 3 && strcmp(argv[1], "--snapshot") == 0) {
+        SnapshotFile file(argv[2]);
+        FsmSnapshot snapshot;
+        bool restored = file.read(snapshot) && snapshot.core.state != static_cast<uint8_t>(SystemState::STOPPED) && robotFSM.restore(snapshot);
+        robotFSM.setSnapshotFile(&file);
+        if (restored) {
+            robotFSM.resume();
+        } else {
+            robotFSM.start();
+        }
+        return 0;
+    }
+
+    // --listen <port>: command dari client TCP (frame encodeCommandFrame), bukan dari cin
+    if (argc >= 3 && strcmp(argv[1], "--listen") == 0) {
+        EventQueue queue;
+        CommandServer server;
+        if (!server.listen(static_cast<uint16_t>(atoi(argv[2])))) {
+            cerr << "Cannot listen on port " << argv[2] << endl;
+            return 1;
+        }
+        server.route(0, &queue);
+        robotFSM.setEventQueue(&queue);
+        server.start();
+        robotFSM.startScheduled();
+        return 0;
+    }
+
+    runInteractive(robotFSM);
     
     return 0;
-}
\ No newline at end of file
+}
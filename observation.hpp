@@ -0,0 +1,82 @@
+#ifndef OBSERVATION_H_
+#define OBSERVATION_H_
+
+#include <atomic>
+#include <cstdint>
+#include "state.hpp"
+
+using namespace std;
+
+/**
+ * @brief Consistent copy of the fields monitor threads read while the FSM runs.
+ */
+struct Observation {
+        SystemState state;
+        uint32_t heartbeat;     // lastHeartbeat, in milliseconds
+        int moveCount;
+        int errorCount;
+};
+
+/**
+ * @brief Seqlock publishing an Observation from one writer thread to any number of reader threads.
+ * The writer never blocks or waits. A reader retries while a publish is in progress, so it always
+ * gets all four fields from the same publish.
+ * @note The payload is stored as relaxed atomic words, so torn reads are detected without data races.
+ */
+class ObservationSeqlock {
+
+        private:
+        alignas(64) atomic<uint32_t> sequence;  // Odd while a publish is in progress
+        atomic<uint64_t> stateAndHeartbeat;     // state in the high 32 bits, heartbeat in the low 32 bits
+        atomic<uint64_t> counters;              // moveCount in the high 32 bits, errorCount in the low 32 bits
+
+        public:
+        ObservationSeqlock() : sequence(0), stateAndHeartbeat(0), counters(0) {}
+
+        /**
+         * @brief Publish a new observation, writer side only.
+         */
+        void publish(const Observation &o) {
+                uint32_t s = sequence.load(memory_order_relaxed);
+                sequence.store(s + 1, memory_order_relaxed);
+                atomic_thread_fence(memory_order_release);
+                stateAndHeartbeat.store(static_cast<uint64_t>(o.state) << 32 | o.heartbeat, memory_order_relaxed);
+                counters.store(static_cast<uint64_t>(static_cast<uint32_t>(o.moveCount)) << 32 | static_cast<uint32_t>(o.errorCount),
+                               memory_order_relaxed);
+                sequence.store(s + 2, memory_order_release);
+        }
+
+        /**
+         * @brief Try to read the last observation once.
+         * @return false if a publish overlapped the read, o is then unspecified.
+         */
+        bool tryRead(Observation &o) const {
+                uint32_t before = sequence.load(memory_order_acquire);
+                if (before & 1) return false;
+                uint64_t first = stateAndHeartbeat.load(memory_order_relaxed);
+                uint64_t second = counters.load(memory_order_relaxed);
+                atomic_thread_fence(memory_order_acquire);
+                if (sequence.load(memory_order_relaxed) != before) return false;
+                o.state = static_cast<SystemState>(first >> 32);
+                o.heartbeat = static_cast<uint32_t>(first);
+                o.moveCount = static_cast<int>(static_cast<uint32_t>(second >> 32));
+                o.errorCount = static_cast<int>(static_cast<uint32_t>(second));
+                return true;
+        }
+
+        /**
+         * @brief Read the last observation, retrying until no publish overlaps.
+         */
+        Observation read() const {
+                Observation o;
+                while (!tryRead(o)) {}
+                return o;
+        }
+
+        /**
+         * @brief Number of publishes so far, readers can use it to skip unchanged observations.
+         */
+        uint32_t version() const { return sequence.load(memory_order_acquire) / 2; }
+};
+
+#endif // OBSERVATION_H_
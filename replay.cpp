@@ -0,0 +1,93 @@
+#include "replay.hpp"
+#include "fsm.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+
+static const char RECORDING_MAGIC[8] = {'F', 'S', 'M', 'R', 'E', 'C', '1', '\0'};
+
+void InputRecording::record(uint32_t time, int32_t command, Event event) {
+    InputEvent e;
+    e.time = time;
+    e.command = command;
+    e.event = static_cast<uint8_t>(event);
+    e.reserved[0] = e.reserved[1] = e.reserved[2] = 0;
+    events.push_back(e);
+}
+
+void InputRecording::clear() { events.clear(); }
+size_t InputRecording::size() const { return events.size(); }
+const InputEvent &InputRecording::at(size_t i) const { return events[i]; }
+const vector<InputEvent> &InputRecording::getEvents() const { return events; }
+
+bool InputRecording::save(const string &path) const {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) return false;
+    uint64_t count = events.size();
+    out.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char *>(events.data()), static_cast<streamsize>(count * sizeof(InputEvent)));
+    return static_cast<bool>(out);
+}
+
+bool InputRecording::load(const string &path) {
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+    char magic[sizeof(RECORDING_MAGIC)];
+    uint64_t count = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&count), sizeof(count));
+    if (!in || memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0) return false;
+    // count dari file yang terpotong atau rusak tidak boleh menentukan alokasi
+    streampos body = in.tellg();
+    in.seekg(0, ios::end);
+    streamoff remaining = in.tellg() - body;
+    in.seekg(body);
+    if (!in || remaining < 0 || count > static_cast<uint64_t>(remaining) / sizeof(InputEvent)) return false;
+    vector<InputEvent> loaded(count);
+    in.read(reinterpret_cast<char *>(loaded.data()), static_cast<streamsize>(count * sizeof(InputEvent)));
+    if (!in) return false;
+    events.swap(loaded);
+    return true;
+}
+
+InputReplayer::InputReplayer(const InputRecording &rec, ReplayPace p) : recording(rec), pace(p) {}
+
+// Jalankan update() sampai FSM kembali menunggu command di IDLE atau berhenti
+void InputReplayer::settle(FSM &fsm) {
+    while (fsm.getCurrentState() != SystemState::IDLE && fsm.getCurrentState() != SystemState::STOPPED) {
+        fsm.getClock().tick();
+        fsm.update();
+    }
+}
+
+void InputReplayer::run(FSM &fsm) {
+    ClockSource &previousClock = fsm.getClock();
+    EventQueue *previousQueue = fsm.getEventQueue();
+    if (pace == ReplayPace::FULL_SPEED) {
+        clock.setMillis(0);
+        fsm.setClock(&clock);
+    }
+    fsm.setEventQueue(&queue);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (fsm.getCurrentState() == SystemState::INIT) fsm.performInit();
+    for (size_t i = 0; i < recording.size() && fsm.getCurrentState() != SystemState::STOPPED; i++) {
+        const InputEvent &e = recording.at(i);
+        settle(fsm);
+        if (fsm.getCurrentState() == SystemState::STOPPED) break;
+        if (pace == ReplayPace::FULL_SPEED) clock.setMillis(e.time);
+        else this_thread::sleep_until(start + chrono::milliseconds(e.time));
+        queue.push(static_cast<Event>(e.event));
+        fsm.getClock().tick();
+        fsm.update();
+    }
+    settle(fsm);
+    if (fsm.getCurrentState() == SystemState::STOPPED) fsm.shutdown();
+
+    fsm.setEventQueue(previousQueue);
+    if (pace == ReplayPace::FULL_SPEED) fsm.setClock(&previousClock);
+}
@@ -0,0 +1,87 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "state.hpp"
+#include "clock.hpp"
+#include "event_queue.hpp"
+
+using namespace std;
+
+class FSM;
+
+/**
+ * @brief One operator command as captured in IDLE.
+ */
+struct InputEvent {
+        uint32_t time;                  // FSM clock millis() when the command was consumed
+        int32_t command;                // Raw command typed (1..5 or invalid), or the event value if it came from a queue
+        uint8_t event;                  // Event dispatched for it
+        uint8_t reserved[3];
+};
+
+/**
+ * @brief Sequence of commands captured by an FSM, see FSM::setInputRecording().
+ */
+class InputRecording {
+
+        private:
+        vector<InputEvent> events;
+
+        public:
+        /**
+         * @brief Append a command.
+         */
+        void record(uint32_t time, int32_t command, Event event);
+
+        void clear();
+        size_t size() const;
+        const InputEvent &at(size_t i) const;
+        const vector<InputEvent> &getEvents() const;
+
+        /**
+         * @brief Write the recording to a binary file.
+         * @return false if the file cannot be written.
+         */
+        bool save(const string &path) const;
+
+        /**
+         * @brief Replace the recording with the content of a file written by save().
+         * @return false if the file cannot be read, is not a recording or is shorter than its event count says, the recording is then unchanged.
+         */
+        bool load(const string &path);
+};
+
+enum class ReplayPace : uint8_t {
+        FULL_SPEED,     // Commands are fed back to back, time comes from a ManualClock set to each recorded time
+        REAL_TIME       // Commands are fed at their recorded time after the start of the replay, time comes from the FSM clock
+};
+
+/**
+ * @brief Feed a recording back into an FSM, returning the same transitions as the recorded run.
+ */
+class InputReplayer {
+
+        private:
+        const InputRecording &recording;
+        ReplayPace pace;
+        ManualClock clock;              // Clock of the FSM during a full-speed replay
+        EventQueue queue;               // Commands are posted here so IDLE consumes them like live input
+
+        void settle(FSM &fsm);
+
+        public:
+        InputReplayer(const InputRecording &recording, ReplayPace pace);
+
+        /**
+         * @brief Run the FSM through the whole recording, like start() with the recorded commands as input.
+         * The FSM is initialized if it is in INIT and shut down if it stops.
+         * @note During a full-speed replay the FSM clock is replaced by a ManualClock starting at 0, the previous clock is restored at the end.
+         * The event queue of the FSM is restored at the end as well.
+         */
+        void run(FSM &fsm);
+};
+
+#endif // REPLAY_H_
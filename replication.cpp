@@ -0,0 +1,302 @@
+#include "replication.hpp"
+#include "fsm.hpp"
+#include "fleet.hpp"
+#include <arpa/inet.h>
+#include <cstring>
+#include <poll.h>
+#include <random>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char REPLICATION_MAGIC[4] = {'F', 'S', 'M', 'R'};
+static const uint8_t REPLICATION_VERSION = 2;
+
+// Little-endian di wire, apa pun byte order host
+static void putLE(uint8_t *out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+static uint64_t getLE(const uint8_t *in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+void encodeReplicationHeader(uint8_t *out, const ReplicationHeader &h) {
+    memcpy(out, h.magic, sizeof(h.magic));
+    putLE(out + 4, h.node, 2);
+    out[6] = h.version;
+    out[7] = h.flags;
+    putLE(out + 8, h.epoch, 4);
+    putLE(out + 12, h.count, 4);
+    putLE(out + 16, h.sequence, 8);
+    putLE(out + 24, h.timeNs, 8);
+}
+
+static void decodeHeader(const uint8_t *in, ReplicationHeader &h) {
+    memcpy(h.magic, in, sizeof(h.magic));
+    h.node = static_cast<uint16_t>(getLE(in + 4, 2));
+    h.version = in[6];
+    h.flags = in[7];
+    h.epoch = static_cast<uint32_t>(getLE(in + 8, 4));
+    h.count = static_cast<uint32_t>(getLE(in + 12, 4));
+    h.sequence = getLE(in + 16, 8);
+    h.timeNs = getLE(in + 24, 8);
+}
+
+void encodeReplicationDelta(uint8_t *out, const ReplicationDelta &d) {
+    putLE(out, d.instance, 4);
+    putLE(out + 4, static_cast<uint32_t>(d.moveCount), 4);
+    putLE(out + 8, static_cast<uint32_t>(d.errorCount), 4);
+    putLE(out + 12, d.lastHeartbeat, 4);
+    putLE(out + 16, d.transitionCount, 8);
+    putLE(out + 24, d.transitionNs, 8);
+    out[32] = d.state;
+    memset(out + 33, 0, REPLICATION_DELTA_BYTES - 33);
+}
+
+static void decodeDelta(const uint8_t *in, ReplicationDelta &d) {
+    d.instance = static_cast<uint32_t>(getLE(in, 4));
+    d.moveCount = static_cast<int32_t>(static_cast<uint32_t>(getLE(in + 4, 4)));
+    d.errorCount = static_cast<int32_t>(static_cast<uint32_t>(getLE(in + 8, 4)));
+    d.lastHeartbeat = static_cast<uint32_t>(getLE(in + 12, 4));
+    d.transitionCount = getLE(in + 16, 8);
+    d.transitionNs = getLE(in + 24, 8);
+    d.state = in[32];
+}
+
+ReplicationPublisher::ReplicationPublisher(uint16_t n, uint32_t keyframeEvery)
+    : node(n), epoch(random_device()()), keyframeTicks(keyframeEvery), ticksSinceKeyframe(0), sequence(0), fd(-1) {
+    memset(&peer, 0, sizeof(peer));
+    memset(&header, 0, sizeof(header));
+    memset(datagram, 0, sizeof(datagram));
+    memset(&stats, 0, sizeof(stats));
+    memcpy(header.magic, REPLICATION_MAGIC, sizeof(REPLICATION_MAGIC));
+    header.node = node;
+    header.version = REPLICATION_VERSION;
+    header.epoch = epoch;
+}
+
+ReplicationPublisher::~ReplicationPublisher() {
+    if (fd >= 0) ::close(fd);
+}
+
+bool ReplicationPublisher::connect(const char *address, uint16_t port, uint8_t ttl) {
+    peer.sin_family = AF_INET;
+    peer.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address, &peer.sin_addr) != 1) return false;
+    if (fd < 0) fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    if (IN_MULTICAST(ntohl(peer.sin_addr.s_addr))) {
+        unsigned char hops = ttl, loop = 1;
+        ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops));
+        ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    return true;
+}
+
+size_t ReplicationPublisher::track(FSM &fsm) {
+    machines.push_back(&fsm);
+    // Transisi yang belum pernah dikirim: delta pertama pasti keluar
+    sent.push_back({UINT64_MAX, 0, 0});
+    return machines.size() - 1;
+}
+
+void ReplicationPublisher::trackFleet(FleetRunner &fleet) {
+    for (size_t i = 0; i < fleet.size(); i++) track(fleet.instance(i));
+}
+
+// Salin nilai terbaru satu FSM ke datagram, kirim jika sudah penuh
+void ReplicationPublisher::append(uint32_t instance, uint64_t nowNs, uint8_t flags) {
+    const FSM &fsm = *machines[instance];
+    ReplicationDelta d;
+    d.instance = instance;
+    d.moveCount = fsm.getMoveCount();
+    d.errorCount = fsm.getErrorCount();
+    d.lastHeartbeat = fsm.getLastHeartbeat();
+    d.transitionCount = fsm.getTransitionCount();
+    d.transitionNs = fsm.getLastTransitionNanos();
+    d.state = static_cast<uint8_t>(fsm.getCurrentState());
+    encodeReplicationDelta(datagram + REPLICATION_HEADER_BYTES + header.count++ * REPLICATION_DELTA_BYTES, d);
+    sent[instance] = {d.transitionCount, d.moveCount, d.errorCount};
+    if (header.count == REPLICATION_DELTAS_PER_DATAGRAM) send(nowNs, flags);
+}
+
+void ReplicationPublisher::send(uint64_t nowNs, uint8_t flags) {
+    header.flags = flags;
+    header.sequence = ++sequence;
+    header.timeNs = nowNs;
+    size_t length = REPLICATION_HEADER_BYTES + header.count * REPLICATION_DELTA_BYTES;
+    encodeReplicationHeader(datagram, header);
+    if (fd < 0 || ::sendto(fd, datagram, length, 0, reinterpret_cast<const sockaddr *>(&peer), sizeof(peer)) < 0) stats.sendErrors++;
+    stats.datagrams++;
+    stats.bytes += length;
+    if (!(flags & REPLICATION_KEYFRAME)) stats.deltas += header.count;
+    header.count = 0;
+}
+
+// Semua FSM, datagram pertama BEGIN dan terakhir END
+void ReplicationPublisher::keyframe(uint64_t nowNs) {
+    uint8_t flags = REPLICATION_KEYFRAME | REPLICATION_KEYFRAME_BEGIN;
+    for (size_t i = 0; i < machines.size(); i++) {
+        bool last = i + 1 == machines.size();
+        append(static_cast<uint32_t>(i), nowNs, last ? flags | REPLICATION_KEYFRAME_END : flags);
+        if (header.count == 0) flags = REPLICATION_KEYFRAME;
+    }
+    if (header.count > 0 || machines.empty()) send(nowNs, flags | REPLICATION_KEYFRAME_END);
+    stats.keyframes++;
+    ticksSinceKeyframe = 0;
+}
+
+size_t ReplicationPublisher::tick(uint64_t nowNs) {
+    stats.ticks++;
+    if (stats.keyframes == 0 || (keyframeTicks && ++ticksSinceKeyframe >= keyframeTicks)) {
+        keyframe(nowNs);
+        return 0;
+    }
+    uint64_t before = stats.deltas + header.count;
+    for (size_t i = 0; i < machines.size(); i++) {
+        const FSM &fsm = *machines[i];
+        const Sent &last = sent[i];
+        if (fsm.getTransitionCount() != last.transitionCount || fsm.getMoveCount() != last.moveCount
+            || fsm.getErrorCount() != last.errorCount) {
+            append(static_cast<uint32_t>(i), nowNs, 0);
+        }
+    }
+    if (header.count > 0) send(nowNs, 0);
+    return static_cast<size_t>(stats.deltas - before);
+}
+
+ReplicationPublisherStats ReplicationPublisher::getStats() const { return stats; }
+
+FsmReplica::FsmReplica()
+    : node(0), instance(0), known(false), state(SystemState::INIT), moveCount(0), errorCount(0), lastHeartbeat(0), transitionCount(0), lastTransitionNs(0) {}
+
+ReplicaMirror::ReplicaMirror(uint32_t limit) : fd(-1), maxReplicas(limit) {
+    for (size_t i = 0; i < STATE_COUNT; i++) stateCounts[i] = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+ReplicaMirror::~ReplicaMirror() {
+    if (fd >= 0) ::close(fd);
+}
+
+bool ReplicaMirror::listen(uint16_t port, const char *group, const char *address) {
+    fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    int yes = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    bool ok = ::inet_pton(AF_INET, address, &addr.sin_addr) == 1 && ::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+    if (ok && group) {
+        ip_mreq membership;
+        membership.imr_interface = addr.sin_addr;
+        ok = ::inet_pton(AF_INET, group, &membership.imr_multiaddr) == 1
+             && ::setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) == 0;
+    }
+    if (!ok) {
+        ::close(fd);
+        fd = -1;
+    }
+    return ok;
+}
+
+size_t ReplicaMirror::poll(int timeoutMs) {
+    if (fd < 0) return 0;
+    pollfd p = {fd, POLLIN, 0};
+    if (::poll(&p, 1, timeoutMs) <= 0) return 0;
+    uint8_t datagram[2048];
+    size_t applied = 0;
+    while (true) {
+        ssize_t n = ::recv(fd, datagram, sizeof(datagram), 0);
+        if (n < 0) return applied;
+        if (apply(datagram, static_cast<size_t>(n))) applied++;
+    }
+}
+
+bool ReplicaMirror::apply(const uint8_t *data, size_t length) {
+    ReplicationHeader header;
+    if (length < REPLICATION_HEADER_BYTES) {
+        stats.malformed++;
+        return false;
+    }
+    decodeHeader(data, header);
+    if (memcmp(header.magic, REPLICATION_MAGIC, sizeof(REPLICATION_MAGIC)) != 0 || header.version != REPLICATION_VERSION
+        || header.count > REPLICATION_DELTAS_PER_DATAGRAM || length != REPLICATION_HEADER_BYTES + header.count * REPLICATION_DELTA_BYTES) {
+        stats.malformed++;
+        return false;
+    }
+    if (header.node >= nodes.size()) nodes.resize(header.node + 1, Node{false, 0, 0, false, false, {}});
+    Node &n = nodes[header.node];
+    // Publisher restart: urutan mulai lagi dari awal, FSM dari run sebelumnya dibuang
+    if (!n.seen || header.epoch != n.epoch) {
+        for (const FsmReplica &r : n.replicas) {
+            if (r.known) stateCounts[static_cast<size_t>(r.state)]--;
+        }
+        n.replicas.clear();
+        n.seen = true;
+        n.epoch = header.epoch;
+        n.expected = header.sequence;
+        n.synced = false;
+        n.inKeyframe = false;
+    }
+    if (header.sequence < n.expected) {
+        stats.stale++;
+        return false;
+    }
+    if (header.sequence > n.expected) {
+        stats.gaps++;
+        stats.lost += header.sequence - n.expected;
+        n.synced = false;
+        n.inKeyframe = false;
+    }
+    n.expected = header.sequence + 1;
+    if (header.flags & REPLICATION_KEYFRAME_BEGIN) n.inKeyframe = true;
+    if ((header.flags & REPLICATION_KEYFRAME_END) && n.inKeyframe) {
+        n.synced = true;
+        n.inKeyframe = false;
+    }
+    stats.datagrams++;
+    stats.deltas += header.count;
+    const uint8_t *next = data + REPLICATION_HEADER_BYTES;
+    for (uint32_t i = 0; i < header.count; i++, next += REPLICATION_DELTA_BYTES) {
+        ReplicationDelta d;
+        decodeDelta(next, d);
+        if (d.state >= STATE_COUNT || d.instance >= maxReplicas) {
+            stats.malformed++;
+            continue;
+        }
+        if (d.instance >= n.replicas.size()) n.replicas.resize(d.instance + 1);
+        FsmReplica &r = n.replicas[d.instance];
+        if (r.known) stateCounts[static_cast<size_t>(r.state)]--;
+        r.node = header.node;
+        r.instance = d.instance;
+        r.known = true;
+        r.state = static_cast<SystemState>(d.state);
+        r.moveCount = d.moveCount;
+        r.errorCount = d.errorCount;
+        r.lastHeartbeat = d.lastHeartbeat;
+        r.transitionCount = d.transitionCount;
+        r.lastTransitionNs = d.transitionNs;
+        stateCounts[d.state]++;
+    }
+    return true;
+}
+
+const FsmReplica *ReplicaMirror::find(uint16_t node, uint32_t instance) const {
+    if (node >= nodes.size() || instance >= nodes[node].replicas.size()) return nullptr;
+    const FsmReplica &r = nodes[node].replicas[instance];
+    return r.known ? &r : nullptr;
+}
+
+size_t ReplicaMirror::countInState(SystemState state) const {
+    return static_cast<size_t>(state) < STATE_COUNT ? stateCounts[static_cast<size_t>(state)] : 0;
+}
+
+bool ReplicaMirror::isSynced(uint16_t node) const { return node < nodes.size() && nodes[node].synced; }
+
+ReplicaMirrorStats ReplicaMirror::getStats() const { return stats; }
@@ -0,0 +1,263 @@
+#ifndef REPLICATION_H_
+#define REPLICATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <vector>
+#include "state.hpp"
+
+using namespace std;
+
+class FSM;
+class FleetRunner;
+
+/**
+ * @brief Header of one replication datagram, followed by count ReplicationDelta.
+ * On the wire every field is little-endian, in declaration order without padding, see encodeReplicationHeader().
+ */
+struct ReplicationHeader {
+        char magic[4];                  // "FSMR"
+        uint16_t node;                  // Node publishing the fleet
+        uint8_t version;
+        uint8_t flags;                  // REPLICATION_KEYFRAME* bits
+        uint32_t epoch;                 // Changes when the publisher restarts, sequences start over
+        uint32_t count;                 // Deltas in this datagram
+        uint64_t sequence;              // Datagram index since the publisher started, gaps mean lost datagrams
+        uint64_t timeNs;                // Publisher clock at the tick that sent this datagram
+};
+
+/**
+ * @brief Latest state and counters of one FSM, sent when its transition count or counters changed.
+ * Encoded like the header, see encodeReplicationDelta().
+ */
+struct ReplicationDelta {
+        uint32_t instance;              // Index of the FSM on its node
+        int32_t moveCount;
+        int32_t errorCount;
+        uint32_t lastHeartbeat;         // Heartbeat in milliseconds when the delta was taken
+        uint64_t transitionCount;       // Transitions since construction, coalesced ones included
+        uint64_t transitionNs;          // Publisher clock when the current state was entered
+        uint8_t state;                  // SystemState
+        uint8_t reserved[7];
+};
+
+const uint8_t REPLICATION_KEYFRAME = 1 << 0;            // Datagram of a keyframe carrying every FSM
+const uint8_t REPLICATION_KEYFRAME_BEGIN = 1 << 1;      // First datagram of a keyframe
+const uint8_t REPLICATION_KEYFRAME_END = 1 << 2;        // Last datagram of a keyframe
+const size_t REPLICATION_HEADER_BYTES = 32;             // Encoded ReplicationHeader
+const size_t REPLICATION_DELTA_BYTES = 40;              // Encoded ReplicationDelta
+const size_t REPLICATION_DELTAS_PER_DATAGRAM = 35;      // 1432 byte datagrams, below a 1500 byte MTU
+
+/**
+ * @brief Write a header in the wire format, REPLICATION_HEADER_BYTES long.
+ */
+void encodeReplicationHeader(uint8_t *out, const ReplicationHeader &header);
+
+/**
+ * @brief Write a delta in the wire format, REPLICATION_DELTA_BYTES long.
+ */
+void encodeReplicationDelta(uint8_t *out, const ReplicationDelta &delta);
+
+struct ReplicationPublisherStats {
+        uint64_t ticks;
+        uint64_t datagrams;
+        uint64_t deltas;                // Delta datagrams only, keyframes excluded
+        uint64_t keyframes;
+        uint64_t bytes;
+        uint64_t sendErrors;
+};
+
+/**
+ * @brief Streams the transitions of the FSMs of this node to peer nodes over UDP, unicast or multicast.
+ * Each tick() compares every tracked FSM with what was last sent and packs only the changed ones into
+ * datagrams, so several transitions of one FSM in a tick coalesce into one delta carrying the latest
+ * state, counters and transition count, and an idle fleet sends nothing.
+ * A keyframe with every FSM goes out on the first tick and every keyframeTicks ticks after, so a new peer
+ * or one that lost datagrams gets back in sync; on average it adds fleet size / keyframeTicks deltas per tick.
+ * @note tick() reads the FSMs directly, call it from the thread driving them (after FleetRunner::step() for a fleet).
+ * The FSMs are not copied, they must outlive the publisher.
+ */
+class ReplicationPublisher {
+
+        private:
+        struct Sent {
+                uint64_t transitionCount;
+                int32_t moveCount;
+                int32_t errorCount;
+        };
+
+        uint16_t node;
+        uint32_t epoch;
+        uint32_t keyframeTicks;
+        uint32_t ticksSinceKeyframe;
+        uint64_t sequence;
+        int fd;
+        sockaddr_in peer;
+        vector<FSM *> machines;
+        vector<Sent> sent;              // Values of the last delta of each FSM
+        ReplicationHeader header;
+        uint8_t datagram[REPLICATION_HEADER_BYTES + REPLICATION_DELTAS_PER_DATAGRAM * REPLICATION_DELTA_BYTES];  // Deltas encoded after the header
+        ReplicationPublisherStats stats;
+
+        void append(uint32_t instance, uint64_t nowNs, uint8_t flags);
+        void send(uint64_t nowNs, uint8_t flags);
+        void keyframe(uint64_t nowNs);
+
+        public:
+        /**
+         * @param node Identifier of this node, unique among the peers.
+         * @param keyframeTicks Ticks between two keyframes, 0 for a keyframe on the first tick only.
+         */
+        explicit ReplicationPublisher(uint16_t node, uint32_t keyframeTicks = 1000);
+        ~ReplicationPublisher();
+        ReplicationPublisher(const ReplicationPublisher &) = delete;
+        ReplicationPublisher &operator=(const ReplicationPublisher &) = delete;
+
+        /**
+         * @brief Send to address:port, a multicast group (224.0.0.0/4) reaches every node that joined it.
+         * @param ttl Multicast hop limit, 1 stays on the local network.
+         * @return false if the address is invalid or the socket cannot be created.
+         */
+        bool connect(const char *address, uint16_t port, uint8_t ttl = 1);
+
+        /**
+         * @brief Replicate an FSM.
+         * @return Its instance index in the deltas.
+         */
+        size_t track(FSM &fsm);
+
+        /**
+         * @brief Replicate every FSM of a fleet, FSM i gets instance index i if nothing else was tracked before.
+         */
+        void trackFleet(FleetRunner &fleet);
+
+        /**
+         * @brief Send the FSMs changed since the previous tick, and a keyframe when it is due.
+         * @param nowNs Time stamped on the datagrams, for example the fleet clock.
+         * @return The number of deltas sent, keyframes excluded.
+         */
+        size_t tick(uint64_t nowNs);
+
+        ReplicationPublisherStats getStats() const;
+};
+
+/**
+ * @brief Read-only copy of a remote FSM, with the getters of FSM.
+ */
+class FsmReplica {
+
+        friend class ReplicaMirror;
+
+        private:
+        uint16_t node;
+        uint32_t instance;
+        bool known;                     // Received at least once
+        SystemState state;
+        int moveCount;
+        int errorCount;
+        uint32_t lastHeartbeat;
+        uint64_t transitionCount;
+        uint64_t lastTransitionNs;
+
+        public:
+        FsmReplica();
+
+        uint16_t getNode() const { return node; }
+        uint32_t getInstance() const { return instance; }
+        SystemState getCurrentState() const { return state; }
+        int getMoveCount() const { return moveCount; }
+        int getErrorCount() const { return errorCount; }
+        uint32_t getLastHeartbeat() const { return lastHeartbeat; }
+        uint64_t getTransitionCount() const { return transitionCount; }
+
+        /**
+         * @brief Get the time the current state was entered, on the clock of the publisher.
+         */
+        uint64_t getLastTransitionNanos() const { return lastTransitionNs; }
+};
+
+struct ReplicaMirrorStats {
+        uint64_t datagrams;
+        uint64_t deltas;
+        uint64_t gaps;                  // Sequence gaps seen, each one unsyncs its node until the next keyframe
+        uint64_t lost;                  // Datagrams missing in those gaps
+        uint64_t stale;                 // Duplicated or reordered datagrams dropped
+        uint64_t malformed;
+};
+
+/**
+ * @brief Global view of the fleets of every peer node, fed by their ReplicationPublisher.
+ * Deltas carry absolute values, so a lost datagram only leaves the FSMs it carried behind until they
+ * change again or the next keyframe arrives; isSynced() tells whether a node is known to be complete.
+ * countInState() is kept up to date on every delta, it costs nothing to query.
+ * A node that restarts with a new epoch drops every replica of its previous run.
+ * @note Not thread-safe, query from the thread calling poll().
+ */
+class ReplicaMirror {
+
+        private:
+        struct Node {
+                bool seen;
+                uint32_t epoch;
+                uint64_t expected;              // Next sequence
+                bool synced;                    // A complete keyframe arrived and no datagram was lost since
+                bool inKeyframe;                // Keyframe datagrams received without gap so far
+                vector<FsmReplica> replicas;
+        };
+
+        int fd;
+        uint32_t maxReplicas;                   // Instances accepted per node, deltas above are malformed
+        vector<Node> nodes;                     // Indexed by node identifier
+        size_t stateCounts[STATE_COUNT];
+        ReplicaMirrorStats stats;
+
+        public:
+        /**
+         * @param maxReplicas Largest fleet accepted from one node, a delta with a higher instance index is
+         * counted as malformed and skipped so a corrupt datagram cannot make the mirror allocate for it.
+         */
+        explicit ReplicaMirror(uint32_t maxReplicas = 65536);
+        ~ReplicaMirror();
+        ReplicaMirror(const ReplicaMirror &) = delete;
+        ReplicaMirror &operator=(const ReplicaMirror &) = delete;
+
+        /**
+         * @brief Receive datagrams on port.
+         * @param group Multicast group to join, null for unicast.
+         * @return false if the socket cannot be bound or the group joined.
+         */
+        bool listen(uint16_t port, const char *group = nullptr, const char *address = "0.0.0.0");
+
+        /**
+         * @brief Receive and apply the pending datagrams.
+         * @param timeoutMs Maximum wait for the first datagram, 0 to only take what is ready.
+         * @return The number of datagrams applied.
+         */
+        size_t poll(int timeoutMs);
+
+        /**
+         * @brief Apply one datagram, for transports other than the socket of listen().
+         * @return false if the datagram is malformed or stale.
+         */
+        bool apply(const uint8_t *data, size_t length);
+
+        /**
+         * @brief Get the replica of an FSM, null if nothing was received for it yet.
+         */
+        const FsmReplica *find(uint16_t node, uint32_t instance) const;
+
+        /**
+         * @brief Number of known FSMs of every node currently in state.
+         */
+        size_t countInState(SystemState state) const;
+
+        /**
+         * @brief Whether a complete keyframe of node arrived and no datagram of it was lost since.
+         */
+        bool isSynced(uint16_t node) const;
+
+        ReplicaMirrorStats getStats() const;
+};
+
+#endif // REPLICATION_H_
@@ -0,0 +1,63 @@
+#include "scheduler.hpp"
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+TickScheduler::TickScheduler(uint32_t periodMs, uint32_t spinTailUs)
+    : period(chrono::milliseconds(periodMs)), spinTail(chrono::microseconds(spinTailUs)) {
+    reset();
+}
+
+void TickScheduler::reset() {
+    started = false;
+    stats = TickStats{0, 0, 0, 0, 0.0, 0};
+    jitterSum = 0.0;
+}
+
+void TickScheduler::setPeriod(uint32_t periodMs) { period = chrono::milliseconds(periodMs); }
+void TickScheduler::setSpinTail(uint32_t spinTailUs) { spinTail = chrono::microseconds(spinTailUs); }
+const TickStats &TickScheduler::getStats() const { return stats; }
+
+// Tunggu sampai deadline berikutnya: sleep dulu, lalu busy-wait di ujung
+void TickScheduler::waitNextTick() {
+    if (!started) {
+        started = true;
+        nextDeadline = chrono::steady_clock::now();
+    } else {
+        if (nextDeadline - spinTail > chrono::steady_clock::now()) {
+            this_thread::sleep_until(nextDeadline - spinTail);
+        }
+        while (chrono::steady_clock::now() < nextDeadline) {
+        }
+    }
+    tickStart = chrono::steady_clock::now();
+    int64_t jitter = chrono::duration_cast<chrono::nanoseconds>(tickStart - nextDeadline).count();
+    if (stats.ticks == 0 || jitter < stats.minJitter) stats.minJitter = jitter;
+    if (stats.ticks == 0 || jitter > stats.maxJitter) stats.maxJitter = jitter;
+    jitterSum += static_cast<double>(jitter);
+    stats.ticks++;
+    stats.meanJitter = jitterSum / static_cast<double>(stats.ticks);
+    nextDeadline += period;
+}
+
+// Catat durasi tick dan overrun, deadline yang terlewat dilompati
+void TickScheduler::endTick() {
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    int64_t work = chrono::duration_cast<chrono::nanoseconds>(now - tickStart).count();
+    if (work > stats.maxWork) stats.maxWork = work;
+    if (now > nextDeadline && period.count() > 0) {
+        stats.overruns++;
+        int64_t missed = (now - nextDeadline) / period;
+        nextDeadline += period * (missed + 1);
+    }
+}
+
+void TickScheduler::printStats() const {
+    cout << "[Ticks] Count=" << stats.ticks
+         << " Overruns=" << stats.overruns
+         << " Jitter(ns) min=" << stats.minJitter
+         << " mean=" << static_cast<int64_t>(stats.meanJitter)
+         << " max=" << stats.maxJitter
+         << " MaxWork(ns)=" << stats.maxWork << endl;
+}
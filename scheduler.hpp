@@ -0,0 +1,77 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Tick timing statistics, all durations in nanoseconds.
+ * Jitter is the distance between the time a tick started and its deadline.
+ */
+struct TickStats {
+        uint64_t ticks;                 // Number of ticks run
+        uint64_t overruns;              // Ticks whose handler did not finish before the next deadline
+        int64_t minJitter;              // Smallest start jitter
+        int64_t maxJitter;              // Largest start jitter
+        double meanJitter;              // Mean start jitter
+        int64_t maxWork;                // Longest tick handler
+};
+
+/**
+ * @brief Fixed-rate tick scheduler driven by steady_clock absolute deadlines.
+ * Deadlines are computed as start + n * period, so sleep inaccuracy never accumulates into drift.
+ * The thread sleeps until spinTail before each deadline, then busy-waits the rest for sub-millisecond jitter.
+ * When a tick overruns, the missed deadlines are skipped instead of being run back to back.
+ */
+class TickScheduler {
+
+        private:
+        chrono::nanoseconds period;     // Tick period
+        chrono::nanoseconds spinTail;   // Busy-wait duration before each deadline
+        chrono::steady_clock::time_point nextDeadline;  // Deadline of the next tick
+        chrono::steady_clock::time_point tickStart;     // Start time of the current tick
+        bool started;                   // The first deadline was set
+        TickStats stats;
+        double jitterSum;               // Sum of start jitters, for the mean
+
+        public:
+        /**
+         * @brief Create a scheduler.
+         * @param periodMs Tick period in milliseconds, usually the FSM delay. 0 runs ticks back to back.
+         * @param spinTailUs Busy-wait tail in microseconds, 0 only sleeps.
+         */
+        explicit TickScheduler(uint32_t periodMs, uint32_t spinTailUs = 200);
+
+        /**
+         * @brief Wait for the next deadline.
+         * @note The first call returns immediately and sets the time origin.
+         */
+        void waitNextTick();
+
+        /**
+         * @brief Record the end of the tick started by the last waitNextTick(), counting an overrun if it missed the next deadline.
+         */
+        void endTick();
+
+        void setPeriod(uint32_t periodMs);
+        void setSpinTail(uint32_t spinTailUs);
+
+        /**
+         * @brief Get the statistics collected so far.
+         */
+        const TickStats &getStats() const;
+
+        /**
+         * @brief Reset the statistics and the time origin.
+         */
+        void reset();
+
+        /**
+         * @brief Print the tick statistics.
+         */
+        void printStats() const;
+};
+
+#endif // SCHEDULER_H_
@@ -0,0 +1,136 @@
+#include "snapshot.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char SNAPSHOT_MAGIC[8] = {'F', 'S', 'M', 'S', 'N', 'A', 'P', '\0'};
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t checksum;              // FNV-1a of everything after the header
+        uint64_t generation;            // Higher is newer
+        uint64_t historyCount;
+};
+
+struct SnapshotEntry {
+        uint64_t time;
+        uint8_t state;
+        uint8_t reserved[7];
+};
+
+static uint32_t fnv1a(const uint8_t *data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool isValidSnapshot(const FsmSnapshot &snapshot) {
+    const FsmCoreState &core = snapshot.core;
+    if (core.state >= STATE_COUNT || core.historyMode > static_cast<uint8_t>(HistoryMode::COMPACT)) return false;
+    for (uint8_t state : core.deepHistory) {
+        if (state >= STATE_COUNT && state != 0xFF) return false;
+    }
+    for (const HistoryEntry &entry : snapshot.history) {
+        if (static_cast<size_t>(entry.first) >= STATE_COUNT) return false;
+    }
+    return true;
+}
+
+// Lanjutkan dari generasi terbaru yang valid, agar write() pertama tidak menimpa snapshot terbaru
+SnapshotFile::SnapshotFile(const string &p, bool d) : path(p), generation(0), durable(d) {
+    FsmSnapshot existing;
+    uint64_t slotGeneration;
+    for (int slot = 0; slot < 2; slot++) {
+        if (readSlot(slot, existing, slotGeneration) && slotGeneration > generation) generation = slotGeneration;
+    }
+}
+
+// Encode ke buffer lalu tulis ke slot yang lebih lama
+bool SnapshotFile::write(const FsmSnapshot &snapshot) {
+    size_t count = snapshot.history.size();
+    size_t size = sizeof(SnapshotHeader) + sizeof(FsmCoreState) + count * sizeof(SnapshotEntry);
+    buffer.resize(size);
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.generation = generation + 1;
+    header.historyCount = count;
+    uint8_t *body = buffer.data() + sizeof(SnapshotHeader);
+    memcpy(body, &snapshot.core, sizeof(FsmCoreState));
+    SnapshotEntry *entries = reinterpret_cast<SnapshotEntry *>(body + sizeof(FsmCoreState));
+    for (size_t i = 0; i < count; i++) {
+        entries[i].time = snapshot.history[i].second;
+        entries[i].state = static_cast<uint8_t>(snapshot.history[i].first);
+        memset(entries[i].reserved, 0, sizeof(entries[i].reserved));
+    }
+    header.checksum = fnv1a(body, size - sizeof(SnapshotHeader));
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    string file = path + (header.generation & 1 ? ".1" : ".0");
+    int fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::write(fd, buffer.data() + done, size - done);
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+    }
+    bool ok = done == size && (!durable || ::fdatasync(fd) == 0);
+    ::close(fd);
+    if (ok) generation = header.generation;
+    return ok;
+}
+
+bool SnapshotFile::readSlot(int slot, FsmSnapshot &snapshot, uint64_t &slotGeneration) const {
+    string file = path + (slot ? ".1" : ".0");
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    off_t fileSize = ::lseek(fd, 0, SEEK_END);
+    ::lseek(fd, 0, SEEK_SET);
+    SnapshotHeader header;
+    bool ok = fileSize >= static_cast<off_t>(sizeof(SnapshotHeader) + sizeof(FsmCoreState))
+           && ::read(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header))
+           && memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.version == SNAPSHOT_VERSION;
+    vector<uint8_t> body;
+    ok = ok && header.historyCount == (fileSize - sizeof(SnapshotHeader) - sizeof(FsmCoreState)) / sizeof(SnapshotEntry);
+    if (ok) {
+        body.resize(sizeof(FsmCoreState) + header.historyCount * sizeof(SnapshotEntry));
+        ok = ::read(fd, body.data(), body.size()) == static_cast<ssize_t>(body.size())
+          && fnv1a(body.data(), body.size()) == header.checksum;
+    }
+    ::close(fd);
+    if (!ok) return false;
+    memcpy(&snapshot.core, body.data(), sizeof(FsmCoreState));
+    const SnapshotEntry *entries = reinterpret_cast<const SnapshotEntry *>(body.data() + sizeof(FsmCoreState));
+    snapshot.history.resize(header.historyCount);
+    for (size_t i = 0; i < header.historyCount; i++) {
+        snapshot.history[i] = HistoryEntry(static_cast<SystemState>(entries[i].state), entries[i].time);
+    }
+    if (!isValidSnapshot(snapshot)) return false;
+    slotGeneration = header.generation;
+    return true;
+}
+
+// Baca kedua slot, pakai yang valid dan paling baru
+bool SnapshotFile::read(FsmSnapshot &snapshot) {
+    FsmSnapshot other;
+    uint64_t first = 0, second = 0;
+    bool hasFirst = readSlot(0, snapshot, first);
+    bool hasSecond = readSlot(1, other, second);
+    if (hasSecond && (!hasFirst || second > first)) {
+        snapshot = other;
+        first = second;
+    }
+    if (!hasFirst && !hasSecond) return false;
+    generation = first;
+    return true;
+}
+
+uint64_t SnapshotFile::getGeneration() const { return generation; }
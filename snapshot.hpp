@@ -0,0 +1,89 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "state.hpp"
+#include "history.hpp"
+
+using namespace std;
+
+/**
+ * @brief Every FSM field a warm restart needs except the history, copied with a single memcpy.
+ */
+struct FsmCoreState {
+        uint64_t transitionCount;
+        uint64_t historyFirstSequence;          // Sequence number of the first history entry
+        uint64_t historyOverwritten;            // Entries dropped by the history ring
+        uint32_t lastHeartbeat;
+        uint32_t delay;
+        int32_t errorCount;
+        int32_t moveCount;
+        uint8_t state;                          // SystemState
+        uint8_t historyMode;                    // HistoryMode
+        uint8_t deepHistory[SUPERSTATE_LIMIT];  // Substate of each superstate when it was last left
+        uint8_t reserved[6];
+};
+
+static_assert(is_trivially_copyable<FsmCoreState>::value, "FsmCoreState must be trivially copyable");
+
+/**
+ * @brief Complete FSM state, see FSM::capture() and FSM::restore().
+ * @note Reuse one snapshot for periodic captures, the history vector then stops allocating once it reached its size.
+ */
+struct FsmSnapshot {
+        FsmCoreState core;
+        vector<HistoryEntry> history;           // Stored entries, oldest first, times in nanoseconds
+};
+
+/**
+ * @brief Check that every state, history mode and deep history byte of a snapshot is in range.
+ */
+bool isValidSnapshot(const FsmSnapshot &snapshot);
+
+/**
+ * @brief Double-buffered snapshot storage in two files, path.0 and path.1.
+ * Each write() goes to the file not holding the newest snapshot, so a crash in the middle of a write
+ * still leaves the previous snapshot intact. read() picks the newest file whose checksum matches and
+ * whose fields are in range (isValidSnapshot()).
+ * @note A write() reopens, truncates and rewrites a whole file: tens of microseconds of system calls, which
+ * dominate up to thousands of entries (bench snapshot/write16 and snapshot/write1024 cost about the same),
+ * plus the encoding of every history entry, O(history size) at 16 bytes each. At FSM::setSnapshotFile()
+ * interval 1 that cost lands on every update(); prefer a bounded history and an interval of many updates.
+ */
+class SnapshotFile {
+
+        private:
+        string path;
+        uint64_t generation;            // Generation of the newest snapshot written or read
+        bool durable;                   // fdatasync() every write
+        vector<uint8_t> buffer;         // Encoded snapshot, reused by every write
+
+        bool readSlot(int slot, FsmSnapshot &snapshot, uint64_t &slotGeneration) const;
+
+        public:
+        /**
+         * @brief Use the files path.0 and path.1, continuing after the newest valid generation already stored in them.
+         * @param durable Flush each write to the disk, slower but survives a power loss, not only a crash.
+         */
+        explicit SnapshotFile(const string &path, bool durable = false);
+
+        /**
+         * @brief Write a snapshot over the older of the two files.
+         * @return false if the file could not be written, the other one is left untouched.
+         */
+        bool write(const FsmSnapshot &snapshot);
+
+        /**
+         * @brief Read the newest valid snapshot.
+         * @return false if neither file holds a valid snapshot.
+         */
+        bool read(FsmSnapshot &snapshot);
+
+        uint64_t getGeneration() const;
+};
+
+#endif // SNAPSHOT_H_
@@ -0,0 +1,56 @@
+#ifndef STATE_H_
+#define STATE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+enum class SystemState : uint8_t {
+        INIT,
+        IDLE,
+        MOVEMENT,
+        SHOOTING,
+        CALCULATION,
+        ERROR,
+        STOPPED
+};
+
+/**
+ * @brief Input of one update() step.
+ * TICK is used by every state except IDLE, IDLE turns the operator command into one of the other events.
+ */
+enum class Event : uint8_t {
+        TICK,
+        STATUS,         // command 1
+        MOVE,           // command 2
+        SHOOT,          // command 3
+        CALC,           // command 4
+        STOP,           // command 5
+        INVALID         // any other command
+};
+
+const size_t STATE_COUNT = 7;
+const size_t EVENT_COUNT = 7;
+
+/**
+ * @brief Index of a superstate in a StateHierarchy, 0 is the root containing every state.
+ */
+typedef uint8_t Superstate;
+const size_t SUPERSTATE_LIMIT = 8;
+
+constexpr const char *STATE_NAMES[STATE_COUNT] = {"INIT", "IDLE", "MOVEMENT", "SHOOTING", "CALCULATION", "ERROR", "STOPPED"};
+
+/**
+ * @brief Get the name of a state, as written in the enum.
+ */
+constexpr const char *stateName(SystemState state) {
+        return static_cast<size_t>(state) < STATE_COUNT ? STATE_NAMES[static_cast<size_t>(state)] : "UNKNOWN";
+}
+
+/**
+ * @brief Map an operator command (1=Status 2=Move 3=Shoot 4=Calc 5=Stop) to its event.
+ */
+inline Event commandToEvent(int cmd) {
+        return (cmd >= 1 && cmd <= 5) ? static_cast<Event>(cmd) : Event::INVALID;
+}
+
+#endif // STATE_H_
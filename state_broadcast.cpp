@@ -0,0 +1,53 @@
+#include "state_broadcast.hpp"
+
+using namespace std;
+
+StateBroadcast::StateBroadcast(size_t capacity) : mask(0), cursor(0) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        slots[i].sequence.store(0, memory_order_relaxed);
+        slots[i].states.store(0, memory_order_relaxed);
+        slots[i].timeNs.store(0, memory_order_relaxed);
+    }
+}
+
+StateSubscription::StateSubscription(const StateBroadcast &ring)
+    : ring(ring), next(ring.getCursor() + 1), enterMask(0), exitMask(0), missed(0) {}
+
+StateSubscription &StateSubscription::onEnter(SystemState state) {
+    enterMask |= stateBit(state);
+    return *this;
+}
+
+StateSubscription &StateSubscription::onExit(SystemState state) {
+    exitMask |= stateBit(state);
+    return *this;
+}
+
+bool StateSubscription::poll(StateChange &change) {
+    while (true) {
+        uint64_t head = ring.cursor.load(memory_order_acquire);
+        if (next > head) return false;
+        // Tertinggal satu ring penuh: lompat ke change tertua yang masih ada
+        if (head - next > ring.mask) {
+            uint64_t oldest = head - ring.mask;
+            missed += oldest - next;
+            next = oldest;
+        }
+        const StateBroadcast::Slot &slot = ring.slots[next & ring.mask];
+        if (slot.sequence.load(memory_order_acquire) != next) continue;
+        uint64_t states = slot.states.load(memory_order_relaxed);
+        uint64_t timeNs = slot.timeNs.load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        // Slot ditimpa selama dibaca, ulangi dengan head yang baru
+        if (slot.sequence.load(memory_order_relaxed) != next) continue;
+        change.sequence = next++;
+        change.from = static_cast<SystemState>(states & 0xFF);
+        change.to = static_cast<SystemState>(states >> 8 & 0xFF);
+        change.timeNs = timeNs;
+        if (matches(change)) return true;
+    }
+}
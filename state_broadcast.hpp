@@ -0,0 +1,136 @@
+#ifndef STATE_BROADCAST_H_
+#define STATE_BROADCAST_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "state.hpp"
+
+using namespace std;
+
+/**
+ * @brief One state change as seen by subscribers.
+ */
+struct StateChange {
+        uint64_t sequence;      // 1 for the first change published into the ring
+        SystemState from;       // State exited
+        SystemState to;         // State entered
+        uint64_t timeNs;        // Clock time of the transition
+};
+
+/**
+ * @brief Bit of a state in the masks of a StateSubscription.
+ */
+constexpr uint8_t stateBit(SystemState state) { return static_cast<uint8_t>(1u << static_cast<uint8_t>(state)); }
+
+/**
+ * @brief Single-producer broadcast ring of state changes, read by any number of StateSubscription.
+ * publish() writes one slot and bumps the cursor, it never looks at the subscribers, so a slow or dead
+ * consumer cannot block the control thread. A subscriber that falls a full ring behind is lapped:
+ * it skips to the oldest change still in the ring and counts what it missed.
+ * @note Every slot word is a relaxed atomic guarded by the slot sequence, so overwritten reads are detected without data races.
+ */
+class StateBroadcast {
+
+        friend class StateSubscription;
+
+        private:
+        struct alignas(32) Slot {
+                atomic<uint64_t> sequence;      // Sequence of the change held, 0 while it is written
+                atomic<uint64_t> states;        // from in bits 0-7, to in bits 8-15
+                atomic<uint64_t> timeNs;
+        };
+
+        unique_ptr<Slot[]> slots;
+        size_t mask;
+        alignas(64) atomic<uint64_t> cursor;    // Sequence of the last change published
+
+        public:
+        /**
+         * @param capacity Number of changes kept for lagging subscribers, rounded up to a power of two.
+         */
+        explicit StateBroadcast(size_t capacity = 1024);
+        StateBroadcast(const StateBroadcast &) = delete;
+        StateBroadcast &operator=(const StateBroadcast &) = delete;
+
+        /**
+         * @brief Publish a state change, producer side only.
+         */
+        void publish(SystemState from, SystemState to, uint64_t timeNs) {
+                uint64_t s = cursor.load(memory_order_relaxed) + 1;
+                Slot &slot = slots[s & mask];
+                slot.sequence.store(0, memory_order_relaxed);
+                atomic_thread_fence(memory_order_release);
+                slot.states.store(static_cast<uint64_t>(from) | static_cast<uint64_t>(to) << 8, memory_order_relaxed);
+                slot.timeNs.store(timeNs, memory_order_relaxed);
+                slot.sequence.store(s, memory_order_release);
+                cursor.store(s, memory_order_release);
+        }
+
+        /**
+         * @brief Sequence of the last change published, 0 if none.
+         */
+        uint64_t getCursor() const { return cursor.load(memory_order_acquire); }
+
+        size_t capacity() const { return mask + 1; }
+};
+
+/**
+ * @brief Cursor of one consumer into a StateBroadcast, filtered on entered and exited states.
+ * With no onEnter()/onExit() filter every change is delivered, otherwise a change is delivered if it
+ * enters a state registered with onEnter() or exits a state registered with onExit().
+ * Each subscription belongs to one consumer thread; any number of subscriptions can read the same ring.
+ * @note The broadcast is not copied, it must outlive the subscription.
+ */
+class StateSubscription {
+
+        private:
+        const StateBroadcast &ring;
+        uint64_t next;                  // Next sequence to read
+        uint8_t enterMask;
+        uint8_t exitMask;
+        uint64_t missed;
+
+        bool matches(const StateChange &change) const {
+                if ((enterMask | exitMask) == 0) return true;
+                return (enterMask & stateBit(change.to)) || (exitMask & stateBit(change.from));
+        }
+
+        public:
+        /**
+         * @brief Subscribe to the changes published from now on.
+         */
+        explicit StateSubscription(const StateBroadcast &ring);
+
+        StateSubscription &onEnter(SystemState state);
+        StateSubscription &onExit(SystemState state);
+
+        /**
+         * @brief Get the next matching change, never waits.
+         * @return false if no matching change was published yet.
+         */
+        bool poll(StateChange &change);
+
+        /**
+         * @brief Call handler(const StateChange &) for every pending matching change.
+         * @return The number of changes delivered.
+         */
+        template <typename Handler>
+        size_t drain(Handler &&handler) {
+                size_t delivered = 0;
+                StateChange change;
+                while (poll(change)) {
+                        handler(change);
+                        delivered++;
+                }
+                return delivered;
+        }
+
+        /**
+         * @brief Number of changes lost because this subscriber was lapped, filtered or not.
+         */
+        uint64_t getMissed() const { return missed; }
+};
+
+#endif // STATE_BROADCAST_H_
@@ -0,0 +1,4 @@
+#include "static_fsm.hpp"
+
+// Instansiasi eksplisit: semua static_assert dan method RobotStaticFSM dicek di setiap build
+template class StaticFSM<RobotActions, RobotRules>;
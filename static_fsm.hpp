@@ -0,0 +1,358 @@
+#ifndef STATIC_FSM_H_
+#define STATIC_FSM_H_
+
+#include <iostream>
+#include <cstdint>
+#include <type_traits>
+#include "state.hpp"
+#include "history.hpp"
+#include "log_sink.hpp"
+#include "clock.hpp"
+
+using namespace std;
+
+/**
+ * @brief Guards usable in a Rule, each exposes a static check() taking the machine.
+ */
+struct Always {
+        template <class M> static constexpr bool check(const M &) { return true; }
+};
+
+template <int N>
+struct MoveCountAtLeast {
+        template <class M> static bool check(const M &m) { return m.getMoveCount() >= N; }
+};
+
+template <int N>
+struct MoveCountIs {
+        template <class M> static bool check(const M &m) { return m.getMoveCount() == N; }
+};
+
+template <int N>
+struct ErrorCountAbove {
+        template <class M> static bool check(const M &m) { return m.getErrorCount() > N; }
+};
+
+/**
+ * @brief Transition from From to To when On is received and Guard holds.
+ * Rules sharing the same From and On are tried in declaration order, the first one whose guard holds is taken.
+ */
+template <SystemState From, Event On, SystemState To, class Guard = Always>
+struct Rule {
+        static constexpr SystemState from = From;
+        static constexpr Event on = On;
+        static constexpr SystemState to = To;
+        typedef Guard guard;
+};
+
+/**
+ * @brief Run Fn::run(machine) when On is received in From, before the rules are evaluated.
+ */
+template <SystemState From, Event On, class Fn>
+struct OnEvent {
+        static constexpr SystemState from = From;
+        static constexpr Event on = On;
+        typedef Fn fn;
+};
+
+template <class... R> struct Rules {};
+template <class... A> struct Actions {};
+
+/**
+ * @brief Compile-time checks run on a StaticFSM definition.
+ */
+namespace static_fsm_check {
+
+        template <class X, class Y>
+        constexpr bool sameTrigger() { return X::from == Y::from && X::on == Y::on; }
+
+        template <class X, class... Ys>
+        constexpr int countSameRule() {
+                return (0 + ... + ((sameTrigger<X, Ys>() && is_same<typename X::guard, typename Ys::guard>::value) ? 1 : 0));
+        }
+
+        template <class X, class... Ys>
+        constexpr int countSameTrigger() {
+                return (0 + ... + (sameTrigger<X, Ys>() ? 1 : 0));
+        }
+
+        // A rule is shadowed if an earlier rule with the same trigger has no guard
+        template <size_t N>
+        constexpr bool noShadowedRule(const SystemState (&from)[N], const Event (&on)[N], const bool (&always)[N]) {
+                for (size_t i = 0; i < N; i++) {
+                        for (size_t j = 0; j < i; j++) {
+                                if (from[i] == from[j] && on[i] == on[j] && always[j]) return false;
+                        }
+                }
+                return true;
+        }
+
+        // States reachable from INIT through the rules, whatever their guards
+        template <size_t N>
+        constexpr bool reachable(const SystemState (&from)[N], const SystemState (&to)[N], SystemState state) {
+                bool reached[STATE_COUNT] = {};
+                reached[static_cast<size_t>(SystemState::INIT)] = true;
+                for (size_t pass = 0; pass < STATE_COUNT; pass++) {
+                        for (size_t i = 0; i < N; i++) {
+                                if (reached[static_cast<size_t>(from[i])]) reached[static_cast<size_t>(to[i])] = true;
+                        }
+                }
+                return reached[static_cast<size_t>(state)];
+        }
+
+        // Every rule must start from a state reachable from INIT
+        template <size_t N>
+        constexpr bool allRulesReachable(const SystemState (&from)[N], const SystemState (&to)[N]) {
+                for (size_t i = 0; i < N; i++) {
+                        if (!reachable(from, to, from[i])) return false;
+                }
+                return true;
+        }
+
+        // A guarded rule needs a later unguarded rule with the same trigger, so a failing guard never leaves the step undefined
+        template <size_t N>
+        constexpr bool guardedRulesHaveFallback(const SystemState (&from)[N], const Event (&on)[N], const bool (&always)[N]) {
+                for (size_t i = 0; i < N; i++) {
+                        if (always[i]) continue;
+                        bool fallback = false;
+                        for (size_t j = i + 1; j < N; j++) fallback |= from[j] == from[i] && on[j] == on[i] && always[j];
+                        if (!fallback) return false;
+                }
+                return true;
+        }
+
+        // Every reachable state except STOPPED must be able to reach STOPPED, a miswired rule usually closes a cycle without exit
+        template <size_t N>
+        constexpr bool stoppedAlwaysReachable(const SystemState (&from)[N], const SystemState (&to)[N]) {
+                bool stops[STATE_COUNT] = {};
+                stops[static_cast<size_t>(SystemState::STOPPED)] = true;
+                for (size_t pass = 0; pass < STATE_COUNT; pass++) {
+                        for (size_t i = 0; i < N; i++) {
+                                if (stops[static_cast<size_t>(to[i])]) stops[static_cast<size_t>(from[i])] = true;
+                        }
+                }
+                for (size_t s = 0; s < STATE_COUNT; s++) {
+                        if (reachable(from, to, static_cast<SystemState>(s)) && !stops[s]) return false;
+                }
+                return true;
+        }
+
+        // Bit s set if no rule leaves state s
+        template <size_t N>
+        constexpr uint8_t terminalMask(const SystemState (&from)[N], const SystemState (&to)[N]) {
+                uint8_t mask = static_cast<uint8_t>((1u << STATE_COUNT) - 1);
+                for (size_t i = 0; i < N; i++) {
+                        if (to[i] != from[i]) mask &= static_cast<uint8_t>(~(1u << static_cast<size_t>(from[i])));
+                }
+                return mask;
+        }
+}
+
+template <class ActionList, class RuleList>
+class StaticFSM;
+
+/**
+ * @brief State machine whose transitions are fixed at compile time.
+ * The action and rule lists are expanded into update(), so the compiler can inline the whole step:
+ * no virtual call, no function pointer and no allocation once the history ring is preallocated.
+ * Duplicate rules, duplicate actions, rules shadowed by an unguarded rule, guarded rules without an
+ * unguarded fallback, rules or actions in a state unreachable from INIT and reachable states that can never
+ * reach STOPPED are rejected with a static_assert. These checks cannot tell a rule going to the wrong but
+ * still valid state, stress.cpp runs RobotStaticFSM next to FSM and its reference model for that.
+ * The action of a terminal state (no rule leaves it, STOPPED for the robot) runs once, later updates do nothing.
+ * @note The observable behavior of start() (output, history, counters) matches the runtime FSM class.
+ */
+template <class... A, class... R>
+class StaticFSM<Actions<A...>, Rules<R...>> {
+
+        static_assert(sizeof...(R) > 0, "StaticFSM needs at least one rule");
+        static_assert(((static_fsm_check::countSameRule<R, R...>() == 1) && ...), "duplicate transition in StaticFSM rules");
+        static_assert(((static_fsm_check::countSameTrigger<A, A...>() == 1) && ...), "duplicate action in StaticFSM actions");
+
+        static constexpr SystemState ruleFrom[] = {R::from...};
+        static constexpr Event ruleOn[] = {R::on...};
+        static constexpr SystemState ruleTo[] = {R::to...};
+        static constexpr bool ruleAlways[] = {is_same<typename R::guard, Always>::value...};
+        static constexpr uint8_t terminalStates = static_fsm_check::terminalMask(ruleFrom, ruleTo);
+
+        static_assert(static_fsm_check::noShadowedRule(ruleFrom, ruleOn, ruleAlways), "unreachable transition, shadowed by an unguarded rule");
+        static_assert(static_fsm_check::allRulesReachable(ruleFrom, ruleTo), "unreachable transition, its source state cannot be reached from INIT");
+        static_assert((static_fsm_check::reachable(ruleFrom, ruleTo, A::from) && ...), "unreachable action, its state cannot be reached from INIT");
+        static_assert(static_fsm_check::guardedRulesHaveFallback(ruleFrom, ruleOn, ruleAlways), "guarded transition without an unguarded fallback for the same event");
+        static_assert(static_fsm_check::stoppedAlwaysReachable(ruleFrom, ruleTo), "a reachable state can never reach STOPPED");
+
+        private:
+        SystemState currentState;       // Current state of the FSM
+        uint32_t lastHeartbeat;         // Last heartbeat time in milliseconds
+        uint32_t delay;                 // Delay in milliseconds for each state transition
+        int errorCount;                 // Count of errors encountered
+        StateHistory stateHistory;      // List of state and time pairs, optionally a bounded ring
+        int moveCount;                  // Count of movements performed
+        LogSink *sink;                  // Destination of the output
+        bool halted;                    // The action of the terminal state already ran
+
+        public:
+        /**
+         * @brief set currentState to INIT, lastHeartbeat and errorCount to 0, set delay to param.
+         * @param historyCapacity Number of history slots, 0 keeps the unbounded history.
+         */
+        explicit StaticFSM(uint32_t delay = 0, size_t historyCapacity = 0)
+                : currentState(SystemState::INIT), lastHeartbeat(0), delay(delay), errorCount(0), stateHistory(historyCapacity), moveCount(0), sink(&SyncSink::standard()), halted(false) {
+                stateHistory.push(currentState, lastHeartbeat);
+        }
+
+        SystemState getCurrentState() const { return currentState; }
+        uint32_t getLastHeartbeat() const { return lastHeartbeat; }
+        void getDelay(uint32_t &d) const { d = delay; }
+        void setDelay(uint32_t d) { delay = d; }
+        int getErrorCount() const { return errorCount; }
+        void setErrorCount(int count) { errorCount = count; }
+        int getMoveCount() const { return moveCount; }
+        void setMoveCount(int count) { moveCount = count; }
+        vector<HistoryEntry> getStateHistoryNanos() const { return stateHistory.toVector(); }
+
+        vector<pair<SystemState, uint32_t>> getStateHistory() const {
+                vector<pair<SystemState, uint32_t>> out;
+                out.reserve(stateHistory.size());
+                for (auto &entry : stateHistory.view()) out.emplace_back(entry.first, static_cast<uint32_t>(entry.second / NANOS_PER_MILLI));
+                return out;
+        }
+        HistoryView historyView() const { return stateHistory.view(); }
+        void setLogSink(LogSink *s) { sink = s ? s : &SyncSink::standard(); }
+        LogSink &getLogSink() const { return *sink; }
+
+        /**
+         * @brief Transition to a new state, update the heartbeat and record it in the history.
+         */
+        void transitionToState(SystemState newState) {
+                currentState = newState;
+                uint64_t now = SteadyClock::instance().nanos();
+                lastHeartbeat = static_cast<uint32_t>(now / NANOS_PER_MILLI);
+                stateHistory.push(newState, now);
+        }
+
+        /**
+         * @brief Apply one event: run the matching action, then take the first rule whose guard holds.
+         * Does nothing once the action of a terminal state ran.
+         */
+        void dispatch(Event event) {
+                if (halted) return;
+                const SystemState state = currentState;
+                ((state == A::from && event == A::on ? (A::fn::run(*this), 0) : 0), ...);
+                SystemState next = state;
+                bool matched = false;
+                ((!matched && state == R::from && event == R::on && R::guard::check(*this) ? (matched = true, next = R::to, 0) : 0), ...);
+                if (next != state) transitionToState(next);
+                else halted = (terminalStates >> static_cast<size_t>(state)) & 1;
+        }
+
+        /**
+         * @brief Read a command in IDLE and dispatch it, dispatch TICK in every other state.
+         */
+        void update() {
+                dispatch(currentState == SystemState::IDLE ? commandToEvent(readCommand()) : Event::TICK);
+        }
+
+        /**
+         * @brief Run the machine from INIT until STOPPED, then shut it down.
+         */
+        void start() {
+                while (currentState != SystemState::STOPPED) update();
+                update();
+        }
+
+        void printStatus() const {
+                LogLine(*sink) << "[Status] State=" << static_cast<int>(currentState)
+                               << " MoveCount=" << moveCount
+                               << " Errors=" << errorCount << "\n";
+        }
+
+        void printStateHistory() const {
+                LogLine line(*sink);
+                line << "[History]";
+                if (stateHistory.getOverwritten() > 0) {
+                        line << " (overwritten=" << stateHistory.getOverwritten() << ")";
+                }
+                for (auto &entry : stateHistory.view()) {
+                        line << " (" << static_cast<int>(entry.first) << "," << static_cast<uint32_t>(entry.second / NANOS_PER_MILLI) << ")";
+                }
+                line << "\n";
+        }
+
+        private:
+        int readCommand() const {
+                printStatus();
+                LogLine(*sink) << "Commands: 1=Status 2=Move 3=Shoot 4=Calc 5=Stop > ";
+                int cmd = 0; cin >> cmd;
+                return cmd;
+        }
+};
+
+/**
+ * @brief Actions of the robot machine, same output as the perform*() methods of FSM.
+ */
+namespace robot_actions {
+        struct Init {
+                template <class M> static void run(M &m) { LogLine(m.getLogSink()) << "Initializing...\n"; }
+        };
+        struct Status {
+                template <class M> static void run(M &m) { m.printStatus(); m.printStateHistory(); }
+        };
+        struct Invalid {
+                template <class M> static void run(M &m) { LogLine(m.getLogSink()) << "Invalid\n"; }
+        };
+        struct Move {
+                template <class M> static void run(M &m) { LogLine(m.getLogSink()) << "Moving...\n"; m.setMoveCount(m.getMoveCount() + 1); }
+        };
+        struct Shoot {
+                template <class M> static void run(M &m) { LogLine(m.getLogSink()) << "Shooting...\n"; m.setMoveCount(0); }
+        };
+        struct Calculate {
+                template <class M> static void run(M &m) { LogLine(m.getLogSink()) << "Calculating...\n"; }
+        };
+        struct HandleError {
+                template <class M> static void run(M &m) { LogLine(m.getLogSink()) << "Error!\n"; m.setErrorCount(m.getErrorCount() + 1); }
+        };
+        struct Shutdown {
+                template <class M> static void run(M &m) { LogLine(m.getLogSink()) << "Shutting down...\n"; m.printStateHistory(); }
+        };
+}
+
+/**
+ * @brief Actions and rules of the robot machine implemented by FSM.
+ */
+typedef Actions<
+        OnEvent<SystemState::INIT, Event::TICK, robot_actions::Init>,
+        OnEvent<SystemState::IDLE, Event::STATUS, robot_actions::Status>,
+        OnEvent<SystemState::IDLE, Event::INVALID, robot_actions::Invalid>,
+        OnEvent<SystemState::MOVEMENT, Event::TICK, robot_actions::Move>,
+        OnEvent<SystemState::SHOOTING, Event::TICK, robot_actions::Shoot>,
+        OnEvent<SystemState::CALCULATION, Event::TICK, robot_actions::Calculate>,
+        OnEvent<SystemState::ERROR, Event::TICK, robot_actions::HandleError>,
+        OnEvent<SystemState::STOPPED, Event::TICK, robot_actions::Shutdown>
+> RobotActions;
+
+typedef Rules<
+        Rule<SystemState::INIT, Event::TICK, SystemState::IDLE>,
+        Rule<SystemState::IDLE, Event::MOVE, SystemState::MOVEMENT>,
+        Rule<SystemState::IDLE, Event::SHOOT, SystemState::SHOOTING>,
+        Rule<SystemState::IDLE, Event::CALC, SystemState::CALCULATION>,
+        Rule<SystemState::IDLE, Event::STOP, SystemState::STOPPED>,
+        Rule<SystemState::IDLE, Event::INVALID, SystemState::ERROR>,
+        Rule<SystemState::MOVEMENT, Event::TICK, SystemState::SHOOTING, MoveCountAtLeast<3>>,
+        Rule<SystemState::MOVEMENT, Event::TICK, SystemState::IDLE>,
+        Rule<SystemState::SHOOTING, Event::TICK, SystemState::IDLE>,
+        Rule<SystemState::CALCULATION, Event::TICK, SystemState::ERROR, MoveCountIs<0>>,
+        Rule<SystemState::CALCULATION, Event::TICK, SystemState::IDLE>,
+        Rule<SystemState::ERROR, Event::TICK, SystemState::STOPPED, ErrorCountAbove<3>>,
+        Rule<SystemState::ERROR, Event::TICK, SystemState::IDLE>
+> RobotRules;
+
+/**
+ * @brief Compile-time version of the robot machine implemented by FSM, instantiated in static_fsm.cpp.
+ */
+typedef StaticFSM<RobotActions, RobotRules> RobotStaticFSM;
+
+extern template class StaticFSM<RobotActions, RobotRules>;
+
+#endif // STATIC_FSM_H_
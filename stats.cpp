@@ -0,0 +1,141 @@
+#include "stats.hpp"
+#include <cstdio>
+
+using namespace std;
+
+FsmStats::FsmStats() { reset(0); }
+
+void FsmStats::reset(uint64_t now) {
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        entries[s].store(0, memory_order_relaxed);
+        dwellTotal[s].store(0, memory_order_relaxed);
+        dwellMax[s].store(0, memory_order_relaxed);
+        untimedVisits[s].store(0, memory_order_relaxed);
+        handlerCount[s].store(0, memory_order_relaxed);
+        handlerTotal[s].store(0, memory_order_relaxed);
+        for (size_t t = 0; t < STATE_COUNT; t++) transitions[s][t].store(0, memory_order_relaxed);
+        for (size_t b = 0; b < HANDLER_BUCKETS; b++) handlerBuckets[s][b].store(0, memory_order_relaxed);
+    }
+    enteredAt = now;
+}
+
+void FsmStats::recordTransition(SystemState from, SystemState to, uint64_t now) {
+    size_t f = static_cast<size_t>(from);
+    size_t t = static_cast<size_t>(to);
+    uint64_t dwell = now > enteredAt ? now - enteredAt : 0;
+    bump(entries[t]);
+    bump(transitions[f][t]);
+    bump(dwellTotal[f], dwell);
+    if (dwell > dwellMax[f].load(memory_order_relaxed)) dwellMax[f].store(dwell, memory_order_relaxed);
+    enteredAt = now;
+}
+
+// Visit tanpa durasi: enteredAt tidak berubah, visit berikutnya tetap diukur dari waktu yang sama
+void FsmStats::recordUntimedTransition(SystemState from, SystemState to) {
+    size_t f = static_cast<size_t>(from);
+    size_t t = static_cast<size_t>(to);
+    bump(entries[t]);
+    bump(transitions[f][t]);
+    bump(untimedVisits[f]);
+}
+
+// Bucket = jumlah bit durasi, dibatasi ke bucket terakhir
+void FsmStats::recordHandler(SystemState state, uint64_t nanos) {
+    size_t s = static_cast<size_t>(state);
+    size_t bucket = nanos == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(nanos));
+    if (bucket >= HANDLER_BUCKETS) bucket = HANDLER_BUCKETS - 1;
+    bump(handlerCount[s]);
+    bump(handlerTotal[s], nanos);
+    bump(handlerBuckets[s][bucket]);
+}
+
+FsmStatsSnapshot FsmStats::snapshot() const {
+    FsmStatsSnapshot snap;
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        snap.entries[s] = entries[s].load(memory_order_relaxed);
+        snap.dwellTotal[s] = dwellTotal[s].load(memory_order_relaxed);
+        snap.dwellMax[s] = dwellMax[s].load(memory_order_relaxed);
+        snap.untimedVisits[s] = untimedVisits[s].load(memory_order_relaxed);
+        snap.handlerCount[s] = handlerCount[s].load(memory_order_relaxed);
+        snap.handlerTotal[s] = handlerTotal[s].load(memory_order_relaxed);
+        for (size_t t = 0; t < STATE_COUNT; t++) snap.transitions[s][t] = transitions[s][t].load(memory_order_relaxed);
+        for (size_t b = 0; b < HANDLER_BUCKETS; b++) snap.handlerBuckets[s][b] = handlerBuckets[s][b].load(memory_order_relaxed);
+    }
+    return snap;
+}
+
+static string labels(const string &instance, const string &rest) {
+    string out = "{";
+    if (!instance.empty()) out += "instance=\"" + instance + "\"" + (rest.empty() ? "" : ",");
+    return out + rest + "}";
+}
+
+static double seconds(uint64_t nanos) { return static_cast<double>(nanos) / 1e9; }
+
+static string bound(size_t bucket) {
+    char text[32];
+    snprintf(text, sizeof(text), "%g", seconds(1ULL << bucket));
+    return text;
+}
+
+void exportPrometheus(ostream &out, const FsmStatsSnapshot &snap, const string &instance) {
+    out << "# TYPE fsm_state_entries_total counter\n";
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        out << "fsm_state_entries_total" << labels(instance, string("state=\"") + STATE_NAMES[s] + "\"") << " " << snap.entries[s] << "\n";
+    }
+    out << "# TYPE fsm_state_dwell_seconds_total counter\n";
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        out << "fsm_state_dwell_seconds_total" << labels(instance, string("state=\"") + STATE_NAMES[s] + "\"") << " " << seconds(snap.dwellTotal[s]) << "\n";
+    }
+    out << "# TYPE fsm_state_dwell_max_seconds gauge\n";
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        out << "fsm_state_dwell_max_seconds" << labels(instance, string("state=\"") + STATE_NAMES[s] + "\"") << " " << seconds(snap.dwellMax[s]) << "\n";
+    }
+    out << "# TYPE fsm_state_untimed_visits_total counter\n";
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        out << "fsm_state_untimed_visits_total" << labels(instance, string("state=\"") + STATE_NAMES[s] + "\"") << " " << snap.untimedVisits[s] << "\n";
+    }
+    out << "# TYPE fsm_transitions_total counter\n";
+    for (size_t f = 0; f < STATE_COUNT; f++) {
+        for (size_t t = 0; t < STATE_COUNT; t++) {
+            if (snap.transitions[f][t] == 0) continue;
+            out << "fsm_transitions_total"
+                << labels(instance, string("from=\"") + STATE_NAMES[f] + "\",to=\"" + STATE_NAMES[t] + "\"")
+                << " " << snap.transitions[f][t] << "\n";
+        }
+    }
+    out << "# TYPE fsm_handler_duration_seconds histogram\n";
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        if (snap.handlerCount[s] == 0) continue;
+        string state = string("state=\"") + STATE_NAMES[s] + "\"";
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < HANDLER_BUCKETS - 1; b++) {
+            cumulative += snap.handlerBuckets[s][b];
+            out << "fsm_handler_duration_seconds_bucket"
+                << labels(instance, state + ",le=\"" + bound(b) + "\"") << " " << cumulative << "\n";
+        }
+        out << "fsm_handler_duration_seconds_bucket" << labels(instance, state + ",le=\"+Inf\"") << " " << snap.handlerCount[s] << "\n";
+        out << "fsm_handler_duration_seconds_sum" << labels(instance, state) << " " << seconds(snap.handlerTotal[s]) << "\n";
+        out << "fsm_handler_duration_seconds_count" << labels(instance, state) << " " << snap.handlerCount[s] << "\n";
+    }
+}
+
+void exportPlaintext(ostream &out, const FsmStatsSnapshot &snap) {
+    out << "[Stats] State        Entries  Dwell(ms)   MaxDwell(ms)   Untimed  Handler runs  Handler avg(ns)\n";
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        char line[160];
+        snprintf(line, sizeof(line), "[Stats] %-12s %8llu %10.3f %14.3f %9llu %13llu %16.1f\n", STATE_NAMES[s],
+                 static_cast<unsigned long long>(snap.entries[s]), snap.dwellTotal[s] / 1e6, snap.dwellMax[s] / 1e6,
+                 static_cast<unsigned long long>(snap.untimedVisits[s]),
+                 static_cast<unsigned long long>(snap.handlerCount[s]),
+                 snap.handlerCount[s] ? static_cast<double>(snap.handlerTotal[s]) / snap.handlerCount[s] : 0.0);
+        out << line;
+    }
+    out << "[Stats] Transitions (from -> to):";
+    for (size_t f = 0; f < STATE_COUNT; f++) {
+        for (size_t t = 0; t < STATE_COUNT; t++) {
+            if (snap.transitions[f][t]) out << " " << STATE_NAMES[f] << "->" << STATE_NAMES[t] << "=" << snap.transitions[f][t];
+        }
+    }
+    out << "\n";
+}
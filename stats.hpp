@@ -0,0 +1,91 @@
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "state.hpp"
+
+using namespace std;
+
+const size_t HANDLER_BUCKETS = 32;      // Bucket i counts handler runs shorter than 2^i nanoseconds
+
+/**
+ * @brief Plain copy of the FSM counters at one point in time, all durations in nanoseconds.
+ */
+struct FsmStatsSnapshot {
+        uint64_t entries[STATE_COUNT];                          // Transitions into each state
+        uint64_t dwellTotal[STATE_COUNT];                       // Time spent in each state, finished visits only
+        uint64_t dwellMax[STATE_COUNT];                         // Longest finished visit of each state
+        uint64_t untimedVisits[STATE_COUNT];                    // Finished visits without a duration, inside an FSM::applyEvents() batch
+        uint64_t transitions[STATE_COUNT][STATE_COUNT];         // [from][to] transition counts
+        uint64_t handlerCount[STATE_COUNT];                     // update() runs timed in each state
+        uint64_t handlerTotal[STATE_COUNT];                     // Time spent in those runs
+        uint64_t handlerBuckets[STATE_COUNT][HANDLER_BUCKETS];  // Log2 histogram of those runs
+};
+
+/**
+ * @brief Per-state counters of one FSM: entries, dwell times, transition matrix and handler time histograms.
+ * Only the thread driving the FSM writes, using relaxed atomic loads and stores (no locked instruction),
+ * so any other thread may take a snapshot() at any time while the counters stay cheap enough for production.
+ */
+class FsmStats {
+
+        private:
+        atomic<uint64_t> entries[STATE_COUNT];
+        atomic<uint64_t> dwellTotal[STATE_COUNT];
+        atomic<uint64_t> dwellMax[STATE_COUNT];
+        atomic<uint64_t> untimedVisits[STATE_COUNT];
+        atomic<uint64_t> transitions[STATE_COUNT][STATE_COUNT];
+        atomic<uint64_t> handlerCount[STATE_COUNT];
+        atomic<uint64_t> handlerTotal[STATE_COUNT];
+        atomic<uint64_t> handlerBuckets[STATE_COUNT][HANDLER_BUCKETS];
+        uint64_t enteredAt;                     // Time the current state was entered, writer only
+
+        static void bump(atomic<uint64_t> &counter, uint64_t by = 1) {
+                counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed);
+        }
+
+        public:
+        FsmStats();
+
+        /**
+         * @brief Set every counter to 0 and start the current visit at now.
+         */
+        void reset(uint64_t now = 0);
+
+        /**
+         * @brief Count a transition, closing the visit of from.
+         */
+        void recordTransition(SystemState from, SystemState to, uint64_t now);
+
+        /**
+         * @brief Count a transition closing a visit of from whose duration is unknown, dwell times are left alone.
+         */
+        void recordUntimedTransition(SystemState from, SystemState to);
+
+        /**
+         * @brief Count one handler run of the given duration in state.
+         */
+        void recordHandler(SystemState state, uint64_t nanos);
+
+        /**
+         * @brief Copy every counter.
+         */
+        FsmStatsSnapshot snapshot() const;
+};
+
+/**
+ * @brief Write a snapshot in the Prometheus text exposition format.
+ * @param instance Value of the instance label added to every sample, empty for none.
+ */
+void exportPrometheus(ostream &out, const FsmStatsSnapshot &snapshot, const string &instance = "");
+
+/**
+ * @brief Write a snapshot as a human readable table.
+ */
+void exportPlaintext(ostream &out, const FsmStatsSnapshot &snapshot);
+
+#endif // STATS_H_
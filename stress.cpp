@@ -0,0 +1,427 @@
+#include "fsm.hpp"
+#include "static_fsm.hpp"
+#include "batch.hpp"
+#include "hierarchy.hpp"
+#include "replication.hpp"
+#include "watchdog.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+// Profil input: campuran acak dan pola yang sengaja menekan jalur ERROR
+enum class Profile : uint8_t {
+    UNIFORM,            // Command -3..9, termasuk yang invalid
+    INVALID_STORM,      // Hampir semua invalid, cepat sampai STOPPED
+    CALC_ZERO,          // Calc dan Shoot, moveCount selalu 0 saat Calc
+    MOVE_STORM,         // Hampir semua Move, putaran MOVEMENT/SHOOTING
+    NO_STOP             // Tanpa Stop dan invalid, FSM hidup lama
+};
+static const size_t PROFILE_COUNT = 5;
+
+struct StressOptions {
+    size_t threads = 0;             // 0: semua core
+    size_t machines = 4096;         // FSM per thread yang hidup bersamaan
+    size_t history = 64;            // Kapasitas ring history, 0 untuk history tanpa batas
+    uint64_t lifetime = 10000;      // Command per FSM sebelum diganti FSM baru
+    uint32_t seconds = 10;
+    uint64_t seed = 1;
+};
+
+// Model acuan perilaku perform*() untuk memeriksa setiap update()
+struct Model {
+    SystemState state = SystemState::INIT;
+    int moveCount = 0;
+    int errorCount = 0;
+    uint64_t transitions = 0;
+
+    void enter(SystemState next) {
+        if (next != state) transitions++;
+        state = next;
+    }
+
+    // Satu update(), cmd hanya dipakai di IDLE (0 berarti queue kosong)
+    void step(bool hasCommand, int cmd) {
+        switch (state) {
+            case SystemState::INIT: enter(SystemState::IDLE); break;
+            case SystemState::IDLE:
+                if (!hasCommand) break;
+                switch (cmd) {
+                    case 1: break;
+                    case 2: enter(SystemState::MOVEMENT); break;
+                    case 3: enter(SystemState::SHOOTING); break;
+                    case 4: enter(SystemState::CALCULATION); break;
+                    case 5: enter(SystemState::STOPPED); break;
+                    default: enter(SystemState::ERROR);
+                }
+                break;
+            case SystemState::MOVEMENT:
+                moveCount++;
+                enter(moveCount >= 3 ? SystemState::SHOOTING : SystemState::IDLE);
+                break;
+            case SystemState::SHOOTING: moveCount = 0; enter(SystemState::IDLE); break;
+            case SystemState::CALCULATION: enter(moveCount == 0 ? SystemState::ERROR : SystemState::IDLE); break;
+            case SystemState::ERROR:
+                errorCount++;
+                enter(errorCount > 3 ? SystemState::STOPPED : SystemState::IDLE);
+                break;
+            case SystemState::STOPPED: break;
+        }
+    }
+};
+
+struct Slot {
+    unique_ptr<FSM> fsm;
+    unique_ptr<RobotStaticFSM> fixed;   // Versi compile-time, dijalankan berdampingan dengan fsm
+    unique_ptr<FSM> hierarchical;       // FSM dengan HierarchicalTable::robotTable(), command yang sama dengan fsm
+    EventQueue queue;
+    EventQueue hierarchicalQueue;
+    Model model;
+    Profile profile;
+    uint64_t commands;
+};
+
+struct alignas(64) WorkerCounters {
+    atomic<uint64_t> transitions{0};
+    atomic<uint64_t> machines{0};       // FSM yang pernah dibuat
+    atomic<uint64_t> stopped{0};        // FSM yang sampai STOPPED
+    atomic<uint64_t> violations{0};
+};
+
+static atomic<bool> running(true);
+static mutex reportLock;
+static size_t violationsPrinted = 0;
+
+static void bump(atomic<uint64_t> &counter, uint64_t by = 1) { counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed); }
+
+static int randomCommand(Profile profile, mt19937_64 &rng) {
+    uint32_t r = static_cast<uint32_t>(rng() % 100);
+    switch (profile) {
+        case Profile::UNIFORM: return static_cast<int>(rng() % 13) - 3;
+        case Profile::INVALID_STORM: return r < 80 ? (r % 2 ? 0 : 6 + static_cast<int>(rng() % 250)) : 1 + static_cast<int>(rng() % 4);
+        case Profile::CALC_ZERO: return r < 70 ? 4 : 3;
+        case Profile::MOVE_STORM: return r < 90 ? 2 : 1 + static_cast<int>(rng() % 4);
+        case Profile::NO_STOP: return 1 + static_cast<int>(r % 4);
+    }
+    return 0;
+}
+
+static void report(size_t worker, const Slot &slot, const char *what) {
+    lock_guard<mutex> guard(reportLock);
+    if (violationsPrinted++ >= 10) return;
+    const FSM &f = *slot.fsm;
+    printf("[Violation] worker=%zu profile=%d command=%llu: %s (state=%d/%d moveCount=%d/%d errorCount=%d/%d transitions=%llu/%llu)\n",
+           worker, static_cast<int>(slot.profile), static_cast<unsigned long long>(slot.commands), what,
+           static_cast<int>(f.getCurrentState()), static_cast<int>(slot.model.state), f.getMoveCount(), slot.model.moveCount,
+           f.getErrorCount(), slot.model.errorCount, static_cast<unsigned long long>(f.getTransitionCount()),
+           static_cast<unsigned long long>(slot.model.transitions));
+}
+
+static void resetSlot(Slot &slot, const StressOptions &options, ClockSource &clock, mt19937_64 &rng) {
+    slot.fsm.reset(new FSM(0, options.history));
+    slot.fsm->setLogSink(&NullSink::instance());
+    slot.fsm->setClock(&clock);
+    slot.fixed.reset(new RobotStaticFSM(0, options.history));
+    slot.fixed->setLogSink(&NullSink::instance());
+    slot.hierarchical.reset(new FSM(0, options.history));
+    slot.hierarchical->setLogSink(&NullSink::instance());
+    slot.hierarchical->setClock(&clock);
+    slot.hierarchical->setTransitionTable(&HierarchicalTable::robotTable());
+    Event leftover;
+    while (slot.queue.pop(leftover)) {}
+    while (slot.hierarchicalQueue.pop(leftover)) {}
+    slot.fsm->setEventQueue(&slot.queue);
+    slot.hierarchical->setEventQueue(&slot.hierarchicalQueue);
+    slot.model = Model();
+    slot.profile = static_cast<Profile>(rng() % PROFILE_COUNT);
+    slot.commands = 0;
+}
+
+// Invarian setelah setiap update(), dibanding model acuan
+static bool check(size_t worker, const Slot &slot, SystemState before, size_t historyCapacity) {
+    const FSM &f = *slot.fsm;
+    const Model &m = slot.model;
+    const char *what = nullptr;
+    if (f.getMoveCount() < 0 || f.getMoveCount() > 3) what = "moveCount out of 0..3";
+    else if (before == SystemState::SHOOTING && f.getMoveCount() != 0) what = "moveCount not reset by SHOOTING";
+    else if (before == SystemState::ERROR && (f.getCurrentState() == SystemState::STOPPED) != (f.getErrorCount() > 3)) what = "STOPPED not reached exactly when errorCount > 3";
+    else if (f.getErrorCount() > 4) what = "errorCount above 4";
+    else if (f.getCurrentState() != m.state || f.getMoveCount() != m.moveCount || f.getErrorCount() != m.errorCount) what = "diverged from the model";
+    else if (f.getTransitionCount() != m.transitions) what = "transition count diverged from the model";
+    else if (historyCapacity && f.historyView().size() > historyCapacity) what = "history above its capacity";
+    else if (slot.fixed->getCurrentState() != m.state || slot.fixed->getMoveCount() != m.moveCount || slot.fixed->getErrorCount() != m.errorCount) what = "StaticFSM diverged from the model";
+    else if (slot.fixed->historyView().size() != f.historyView().size()) what = "StaticFSM history diverged from FSM";
+    else if (slot.hierarchical->getCurrentState() != m.state || slot.hierarchical->getMoveCount() != m.moveCount
+             || slot.hierarchical->getErrorCount() != m.errorCount || slot.hierarchical->getTransitionCount() != m.transitions) what = "robotTable() diverged from the model";
+    if (!what) return true;
+    report(worker, slot, what);
+    return false;
+}
+
+// applyEvents() harus sama dengan dispatch() per event: state, counter, history, observasi dan matriks transisi
+static bool checkBatch(size_t worker, mt19937_64 &rng, ClockSource &clock, size_t historyCapacity) {
+    FSM batched(0, historyCapacity), single(0, historyCapacity);
+    for (FSM *f : {&batched, &single}) {
+        f->setLogSink(&NullSink::instance());
+        f->setClock(&clock);
+    }
+    Event events[64];
+    size_t count = 1 + rng() % 64;
+    for (size_t i = 0; i < count; i++) events[i] = static_cast<Event>(rng() % EVENT_COUNT);
+    uint32_t version = batched.getObservation().version();
+    batched.applyEvents(span<const Event>(events, count));
+    uint32_t publishes = batched.getObservation().version() - version;
+    for (size_t i = 0; i < count; i++) single.dispatch(events[i]);
+
+    FsmStatsSnapshot a = batched.getStats().snapshot(), b = single.getStats().snapshot();
+    Observation oa = batched.observe(), ob = single.observe();
+    const char *what = nullptr;
+    if (batched.getCurrentState() != single.getCurrentState() || batched.getMoveCount() != single.getMoveCount()
+        || batched.getErrorCount() != single.getErrorCount()) what = "state or counters diverged from dispatch()";
+    else if (batched.getTransitionCount() != single.getTransitionCount()) what = "transition count diverged from dispatch()";
+    else if (batched.getStateHistoryNanos() != single.getStateHistoryNanos()) what = "history diverged from dispatch()";
+    else if (oa.state != ob.state || oa.heartbeat != ob.heartbeat || oa.moveCount != ob.moveCount || oa.errorCount != ob.errorCount) what = "published observation diverged from dispatch()";
+    else if (publishes != 1) what = "batch not published exactly once";
+    else if (memcmp(a.entries, b.entries, sizeof(a.entries)) != 0 || memcmp(a.transitions, b.transitions, sizeof(a.transitions)) != 0) what = "stats diverged from dispatch()";
+    if (!what) return true;
+    lock_guard<mutex> guard(reportLock);
+    if (violationsPrinted++ < 10) printf("[Violation] worker=%zu batch of %zu events: %s\n", worker, count, what);
+    return false;
+}
+
+// FSMBatch (SIMD dan skalar) harus sama bit per bit dengan FSM::dispatch() per mesin, termasuk ukuran di luar kelipatan lebar vektor
+static bool checkFsmBatch(size_t worker, mt19937_64 &rng) {
+    size_t count = 1 + rng() % 67;
+    FSMBatch simd(count), scalar(count);
+    scalar.setForceScalar(true);
+    ManualClock clock(0);
+    vector<unique_ptr<FSM>> machines;
+    for (size_t i = 0; i < count; i++) {
+        machines.emplace_back(new FSM(0, 16));
+        machines.back()->setLogSink(&NullSink::instance());
+        machines.back()->setClock(&clock);
+    }
+    vector<Event> events(count);
+    uint32_t tickPercent = static_cast<uint32_t>(rng() % 100);   // Sebagian stream didominasi TICK, sebagian acak
+    uint32_t now = 0;
+    for (size_t step = 0; step < 64; step++) {
+        now += 1 + static_cast<uint32_t>(rng() % 50);
+        clock.setMillis(now);
+        for (Event &e : events) e = rng() % 100 < tickPercent ? Event::TICK : static_cast<Event>(rng() % EVENT_COUNT);
+        simd.step(events, now);
+        scalar.step(events, now);
+        for (size_t i = 0; i < count; i++) machines[i]->dispatch(events[i]);
+        for (size_t i = 0; i < count; i++) {
+            const FSM &f = *machines[i];
+            for (const FSMBatch *b : {&simd, &scalar}) {
+                if (b->getCurrentState(i) == f.getCurrentState() && b->getMoveCount(i) == f.getMoveCount()
+                    && b->getErrorCount(i) == f.getErrorCount() && b->getLastHeartbeat(i) == f.getLastHeartbeat()
+                    && b->getTransitionCount(i) == f.getTransitionCount()) continue;
+                lock_guard<mutex> guard(reportLock);
+                if (violationsPrinted++ < 10) {
+                    printf("[Violation] worker=%zu FSMBatch/%s machine %zu of %zu step %zu: diverged from dispatch() (state=%d/%d moveCount=%d/%d errorCount=%d/%d heartbeat=%u/%u transitions=%llu/%llu)\n",
+                           worker, b == &simd ? simd.backend() : "scalar", i, count, step,
+                           static_cast<int>(b->getCurrentState(i)), static_cast<int>(f.getCurrentState()), b->getMoveCount(i), f.getMoveCount(),
+                           b->getErrorCount(i), f.getErrorCount(), b->getLastHeartbeat(i), f.getLastHeartbeat(),
+                           static_cast<unsigned long long>(b->getTransitionCount(i)), static_cast<unsigned long long>(f.getTransitionCount()));
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Datagram replikasi dengan delta rusak: delta dilewati sebagai malformed, datagram terpotong ditolak, countInState tetap konsisten
+static bool checkReplication(size_t worker, mt19937_64 &rng) {
+    const uint32_t limit = 1024;
+    ReplicaMirror mirror(limit);
+    ReplicationHeader header = {{'F', 'S', 'M', 'R'}, static_cast<uint16_t>(rng() % 4), 2, REPLICATION_KEYFRAME | REPLICATION_KEYFRAME_BEGIN | REPLICATION_KEYFRAME_END, 1, 2, 1, 0};
+    ReplicationDelta good = {static_cast<uint32_t>(rng() % limit), 0, 0, 0, 1, 0, static_cast<uint8_t>(rng() % STATE_COUNT), {}};
+    ReplicationDelta bad = good;
+    switch (rng() % 4) {
+        case 0: bad.instance = UINT32_MAX; break;
+        case 1: bad.instance = 1000000000; break;
+        case 2: bad.instance = limit + static_cast<uint32_t>(rng() % 1000); break;
+        default: bad.state = static_cast<uint8_t>(STATE_COUNT + rng() % 200);
+    }
+    uint8_t datagram[REPLICATION_HEADER_BYTES + 2 * REPLICATION_DELTA_BYTES];
+    encodeReplicationHeader(datagram, header);
+    bool badFirst = rng() % 2;
+    encodeReplicationDelta(datagram + REPLICATION_HEADER_BYTES, badFirst ? bad : good);
+    encodeReplicationDelta(datagram + REPLICATION_HEADER_BYTES + REPLICATION_DELTA_BYTES, badFirst ? good : bad);
+    bool applied = mirror.apply(datagram, sizeof(datagram));
+    header.sequence++;
+    encodeReplicationHeader(datagram, header);
+    bool truncated = mirror.apply(datagram, static_cast<size_t>(rng() % sizeof(datagram)));
+
+    size_t known = 0;
+    for (size_t i = 0; i < STATE_COUNT; i++) known += mirror.countInState(static_cast<SystemState>(i));
+    const FsmReplica *r = mirror.find(header.node, good.instance);
+    const char *what = nullptr;
+    if (!applied) what = "datagram with one bad delta rejected as a whole";
+    else if (truncated) what = "truncated datagram applied";
+    else if (mirror.getStats().malformed != 2) what = "bad delta or truncated datagram not counted as malformed";
+    else if (!r || r->getCurrentState() != static_cast<SystemState>(good.state)) what = "good delta next to a bad one lost";
+    else if (known != 1) what = "countInState diverged from the known replicas";
+    if (!what) return true;
+    lock_guard<mutex> guard(reportLock);
+    if (violationsPrinted++ < 10) printf("[Violation] worker=%zu replication: %s\n", worker, what);
+    return false;
+}
+
+// FSM yang lama di IDLE lalu macet di MOVEMENT harus terdeteksi sekitar satu tick setelah budget-nya
+static bool checkWatchdog(size_t worker, mt19937_64 &rng) {
+    const uint32_t budget = 100, tickMs = 10;
+    ManualClock clock(0);
+    FSM f(0, 16);
+    f.setLogSink(&NullSink::instance());
+    f.setClock(&clock);
+    f.transitionToState(SystemState::IDLE);
+    Watchdog watchdog(budget, tickMs, 512, clock);
+    watchdog.watch(f);
+    uint32_t idleMs = static_cast<uint32_t>(rng() % 8000);
+    for (uint32_t t = 0; t < idleMs; t++) {
+        clock.advanceMillis(1);
+        if (t % tickMs == 0) watchdog.tick();
+    }
+    f.transitionToState(SystemState::MOVEMENT);
+    uint32_t stalled = 0;
+    while (watchdog.getTimeouts() == 0 && stalled < 10 * budget) {
+        clock.advanceMillis(1);
+        stalled++;
+        if (stalled % tickMs == 0) watchdog.tick();
+    }
+    if (watchdog.getTimeouts() == 1 && stalled <= budget + 2 * tickMs) return true;
+    lock_guard<mutex> guard(reportLock);
+    if (violationsPrinted++ < 10) printf("[Violation] worker=%zu watchdog: MOVEMENT stall after %u ms in IDLE detected after %u ms (budget %u ms)\n", worker, idleMs, stalled, budget);
+    return false;
+}
+
+static void worker(size_t id, const StressOptions &options, WorkerCounters &counters) {
+    mt19937_64 rng(options.seed * 1000003 + id);
+    ManualClock clock(0);
+    vector<Slot> slots(options.machines);
+    for (Slot &slot : slots) resetSlot(slot, options, clock, rng);
+    bump(counters.machines, slots.size());
+    while (running.load(memory_order_relaxed)) {
+        clock.advanceMillis(1);
+        uint64_t transitions = 0, created = 0, stopped = 0, violations = 0;
+        for (Slot &slot : slots) {
+            FSM &f = *slot.fsm;
+            SystemState before = f.getCurrentState();
+            bool hasCommand = before == SystemState::IDLE && rng() % 16 != 0;
+            int cmd = 0;
+            if (hasCommand) {
+                cmd = randomCommand(slot.profile, rng);
+                slot.queue.push(commandToEvent(cmd));
+                slot.hierarchicalQueue.push(commandToEvent(cmd));
+                slot.commands++;
+            }
+            uint64_t count = f.getTransitionCount();
+            f.update();
+            slot.hierarchical->update();
+            slot.fixed->dispatch(hasCommand ? commandToEvent(cmd) : Event::TICK);
+            slot.model.step(hasCommand, cmd);
+            transitions += f.getTransitionCount() - count;
+            if (!check(id, slot, before, options.history)) {
+                violations++;
+                resetSlot(slot, options, clock, rng);
+                created++;
+                continue;
+            }
+            if (f.getCurrentState() == SystemState::STOPPED || slot.commands >= options.lifetime) {
+                if (f.getCurrentState() == SystemState::STOPPED) stopped++;
+                resetSlot(slot, options, clock, rng);
+                created++;
+            }
+        }
+        if (!checkBatch(id, rng, clock, options.history)) violations++;
+        if (!checkFsmBatch(id, rng)) violations++;
+        if (!checkReplication(id, rng)) violations++;
+        if (!checkWatchdog(id, rng)) violations++;
+        bump(counters.transitions, transitions);
+        bump(counters.machines, created);
+        bump(counters.stopped, stopped);
+        bump(counters.violations, violations);
+    }
+}
+
+static double residentMegabytes() {
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    int read = fscanf(f, "%lu %lu", &size, &resident);
+    fclose(f);
+    return read == 2 ? resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20) : 0;
+}
+
+static uint64_t parseNumber(const char *text) { return strtoull(text, nullptr, 10); }
+
+int main(int argc, char **argv) {
+    StressOptions options;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 == argc) options.seconds = 0;
+        else if (strcmp(argv[i], "--threads") == 0) options.threads = parseNumber(argv[i + 1]);
+        else if (strcmp(argv[i], "--machines") == 0) options.machines = parseNumber(argv[i + 1]);
+        else if (strcmp(argv[i], "--history") == 0) options.history = parseNumber(argv[i + 1]);
+        else if (strcmp(argv[i], "--lifetime") == 0) options.lifetime = parseNumber(argv[i + 1]);
+        else if (strcmp(argv[i], "--seconds") == 0) options.seconds = static_cast<uint32_t>(parseNumber(argv[i + 1]));
+        else if (strcmp(argv[i], "--seed") == 0) options.seed = parseNumber(argv[i + 1]);
+        else options.seconds = 0;
+        if (options.seconds == 0) {
+            fprintf(stderr, "Usage: %s [--threads N] [--machines N per thread] [--history capacity, 0 unbounded] "
+                            "[--lifetime commands] [--seconds S] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.threads == 0) options.threads = thread::hardware_concurrency() ? thread::hardware_concurrency() : 1;
+    if (options.machines == 0) options.machines = 1;
+    if (options.lifetime == 0) options.lifetime = 1;
+
+    printf("[Stress] Threads=%zu Machines=%zu History=%zu Lifetime=%llu Seconds=%u\n", options.threads,
+           options.threads * options.machines, options.history, static_cast<unsigned long long>(options.lifetime), options.seconds);
+    vector<WorkerCounters> counters(options.threads);
+    vector<thread> workers;
+    for (size_t i = 0; i < options.threads; i++) workers.emplace_back(worker, i, cref(options), ref(counters[i]));
+
+    // Laporan per detik: laju transisi dan pertumbuhan memori sejak detik pertama
+    uint64_t lastTransitions = 0, totalTransitions = 0, totalMachines = 0, totalViolations = 0, totalStopped = 0;
+    double baseline = 0, rss = 0, peakRate = 0, lowRate = 0;
+    for (uint32_t second = 1; second <= options.seconds; second++) {
+        this_thread::sleep_for(chrono::seconds(1));
+        totalTransitions = totalMachines = totalViolations = totalStopped = 0;
+        for (WorkerCounters &c : counters) {
+            totalTransitions += c.transitions.load(memory_order_relaxed);
+            totalMachines += c.machines.load(memory_order_relaxed);
+            totalViolations += c.violations.load(memory_order_relaxed);
+            totalStopped += c.stopped.load(memory_order_relaxed);
+        }
+        double rate = static_cast<double>(totalTransitions - lastTransitions);
+        lastTransitions = totalTransitions;
+        rss = residentMegabytes();
+        if (second == 1) baseline = rss;
+        // Detik pertama termasuk pembuatan FSM awal, tidak dihitung untuk laju minimum
+        if (second == 2 || (second > 2 && rate < lowRate)) lowRate = rate;
+        if (rate > peakRate) peakRate = rate;
+        printf("[Stress] t=%us Transitions/s=%.0f Machines=%llu Stopped=%llu Violations=%llu RSS=%.1fMB Growth=%+.1fMB\n", second, rate,
+               static_cast<unsigned long long>(totalMachines), static_cast<unsigned long long>(totalStopped),
+               static_cast<unsigned long long>(totalViolations), rss, rss - baseline);
+        fflush(stdout);
+    }
+    running.store(false);
+    for (thread &t : workers) t.join();
+
+    printf("[Stress] Total transitions=%llu Mean/s=%.0f Peak/s=%.0f Low/s=%.0f Machines=%llu Violations=%llu Growth=%+.1fMB\n",
+           static_cast<unsigned long long>(totalTransitions), static_cast<double>(totalTransitions) / options.seconds,
+           peakRate, options.seconds > 1 ? lowRate : peakRate, static_cast<unsigned long long>(totalMachines),
+           static_cast<unsigned long long>(totalViolations), rss - baseline);
+    return totalViolations == 0 ? 0 : 2;
+}
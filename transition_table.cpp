@@ -0,0 +1,107 @@
+#include "transition_table.hpp"
+#include "fsm.hpp"
+
+using namespace std;
+
+TransitionTable::TransitionTable() {
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        for (size_t e = 0; e < EVENT_COUNT; e++) {
+            table[s][e].next = static_cast<SystemState>(s);
+            table[s][e].resume = 0;
+            table[s][e].action = nullptr;
+        }
+        for (size_t t = 0; t < STATE_COUNT; t++) exitMasks[s][t] = 0;
+    }
+}
+
+void TransitionTable::set(SystemState state, Event event, SystemState next, TransitionAction action) {
+    Transition &t = table[static_cast<size_t>(state)][static_cast<size_t>(event)];
+    t.next = next;
+    t.resume = 0;
+    t.action = action;
+}
+
+void TransitionTable::setResume(SystemState state, Event event, Superstate superstate) {
+    table[static_cast<size_t>(state)][static_cast<size_t>(event)].resume = static_cast<uint8_t>(superstate + 1);
+}
+
+void TransitionTable::setExits(SystemState from, SystemState to, uint8_t mask) {
+    exitMasks[static_cast<size_t>(from)][static_cast<size_t>(to)] = mask;
+}
+
+// Aksi default, sama dengan perform*() di fsm.cpp
+namespace default_actions {
+
+SystemState actionInit(FSM &fsm, SystemState next) {
+    LogLine(fsm.getLogSink()) << "Initializing...\n";
+    return next;
+}
+
+SystemState actionStatus(FSM &fsm, SystemState next) {
+    fsm.printStatus();
+    fsm.printStateHistory();
+    return next;
+}
+
+SystemState actionInvalid(FSM &fsm, SystemState next) {
+    LogLine(fsm.getLogSink()) << "Invalid\n";
+    return next;
+}
+
+SystemState actionMovement(FSM &fsm, SystemState next) {
+    LogLine(fsm.getLogSink()) << "Moving...\n";
+    fsm.setMoveCount(fsm.getMoveCount() + 1);
+    return fsm.getMoveCount() >= 3 ? SystemState::SHOOTING : next;
+}
+
+SystemState actionShooting(FSM &fsm, SystemState next) {
+    LogLine(fsm.getLogSink()) << "Shooting...\n";
+    fsm.setMoveCount(0);
+    return next;
+}
+
+SystemState actionCalculation(FSM &fsm, SystemState next) {
+    LogLine(fsm.getLogSink()) << "Calculating...\n";
+    return fsm.getMoveCount() == 0 ? SystemState::ERROR : next;
+}
+
+SystemState actionError(FSM &fsm, SystemState next) {
+    LogLine(fsm.getLogSink()) << "Error!\n";
+    fsm.setErrorCount(fsm.getErrorCount() + 1);
+    return fsm.getErrorCount() > 3 ? SystemState::STOPPED : next;
+}
+
+SystemState actionShutdown(FSM &fsm, SystemState next) {
+    fsm.shutdown();
+    return next;
+}
+
+} // namespace default_actions
+
+using namespace default_actions;
+
+static TransitionTable buildDefaultTable() {
+    TransitionTable t;
+    for (size_t e = 0; e < EVENT_COUNT; e++) {
+        Event event = static_cast<Event>(e);
+        t.set(SystemState::INIT, event, SystemState::IDLE, actionInit);
+        t.set(SystemState::MOVEMENT, event, SystemState::IDLE, actionMovement);
+        t.set(SystemState::SHOOTING, event, SystemState::IDLE, actionShooting);
+        t.set(SystemState::CALCULATION, event, SystemState::IDLE, actionCalculation);
+        t.set(SystemState::ERROR, event, SystemState::IDLE, actionError);
+        t.set(SystemState::STOPPED, event, SystemState::STOPPED, actionShutdown);
+    }
+    t.set(SystemState::IDLE, Event::TICK, SystemState::IDLE);
+    t.set(SystemState::IDLE, Event::STATUS, SystemState::IDLE, actionStatus);
+    t.set(SystemState::IDLE, Event::MOVE, SystemState::MOVEMENT);
+    t.set(SystemState::IDLE, Event::SHOOT, SystemState::SHOOTING);
+    t.set(SystemState::IDLE, Event::CALC, SystemState::CALCULATION);
+    t.set(SystemState::IDLE, Event::STOP, SystemState::STOPPED);
+    t.set(SystemState::IDLE, Event::INVALID, SystemState::ERROR, actionInvalid);
+    return t;
+}
+
+const TransitionTable &TransitionTable::defaultTable() {
+    static const TransitionTable table = buildDefaultTable();
+    return table;
+}
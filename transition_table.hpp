@@ -0,0 +1,94 @@
+#ifndef TRANSITION_TABLE_H_
+#define TRANSITION_TABLE_H_
+
+#include "state.hpp"
+
+class FSM;
+
+/**
+ * @brief Side effect and guard of a table transition.
+ * @param fsm The FSM being updated.
+ * @param next The next state stored in the table.
+ * @return The state to transition to, usually next, a guard may pick another one.
+ */
+typedef SystemState (*TransitionAction)(FSM &fsm, SystemState next);
+
+struct Transition {
+        SystemState next;               // Next state when action is null or returns it unchanged
+        uint8_t resume;                 // 1 + superstate whose deep history replaces next if recorded, 0 for none
+        TransitionAction action;        // Optional side effect and guard, may be null
+};
+
+/**
+ * @brief Dense [state][event] table of transitions used by FSM::dispatch().
+ * Dispatching an event is a single indexed load plus at most one indirect call.
+ * Copy defaultTable() and override entries with set() to reconfigure the machine without touching fsm.cpp.
+ */
+class TransitionTable {
+
+        private:
+        Transition table[STATE_COUNT][EVENT_COUNT];
+        uint8_t exitMasks[STATE_COUNT][STATE_COUNT];    // Superstates left by each [from][to] transition, bit i for superstate i
+
+        public:
+        /**
+         * @brief Create a table where every event keeps the current state and does nothing.
+         */
+        TransitionTable();
+
+        /**
+         * @brief Set the transition taken when event is received in state.
+         */
+        void set(SystemState state, Event event, SystemState next, TransitionAction action = nullptr);
+
+        /**
+         * @brief Resume the deep history of a superstate instead of going to next, once the FSM has left it at least once.
+         */
+        void setResume(SystemState state, Event event, Superstate superstate);
+
+        /**
+         * @brief Set the superstates left by a from -> to transition, whose deep history the FSM then records.
+         * @param mask Bit i for superstate i, filled by HierarchicalTable::compile().
+         */
+        void setExits(SystemState from, SystemState to, uint8_t mask);
+
+        uint8_t exits(SystemState from, SystemState to) const {
+                return exitMasks[static_cast<size_t>(from)][static_cast<size_t>(to)];
+        }
+
+        /**
+         * @brief Get the transition taken when event is received in state.
+         */
+        const Transition &get(SystemState state, Event event) const {
+                return table[static_cast<size_t>(state)][static_cast<size_t>(event)];
+        }
+
+        /**
+         * @brief Get the table describing the rules of the perform*() methods:
+         * - INIT: print "Initializing...", go to IDLE
+         * - IDLE: Status prints status and history, Move/Shoot/Calc/Stop go to their state, anything else goes to ERROR
+         * - MOVEMENT: increment moveCount, go to SHOOTING if moveCount reaches 3, IDLE otherwise
+         * - SHOOTING: reset moveCount, go to IDLE
+         * - CALCULATION: go to ERROR if moveCount is 0, IDLE otherwise
+         * - ERROR: increment errorCount, go to STOPPED if errorCount exceeds 3, IDLE otherwise
+         * - STOPPED: shutdown
+         * @note The table is built once, on first use.
+         */
+        static const TransitionTable &defaultTable();
+};
+
+/**
+ * @brief Actions of defaultTable(), for tables declaring the same rules another way.
+ */
+namespace default_actions {
+        SystemState actionInit(FSM &fsm, SystemState next);
+        SystemState actionStatus(FSM &fsm, SystemState next);
+        SystemState actionInvalid(FSM &fsm, SystemState next);
+        SystemState actionMovement(FSM &fsm, SystemState next);
+        SystemState actionShooting(FSM &fsm, SystemState next);
+        SystemState actionCalculation(FSM &fsm, SystemState next);
+        SystemState actionError(FSM &fsm, SystemState next);
+        SystemState actionShutdown(FSM &fsm, SystemState next);
+}
+
+#endif // TRANSITION_TABLE_H_
@@ -0,0 +1,146 @@
+#include "watchdog.hpp"
+#include "fsm.hpp"
+#include <chrono>
+
+using namespace std;
+
+// Konstruktor, semua slot kosong
+Watchdog::Watchdog(uint32_t budgetMs, uint32_t resolutionMs, size_t slotCount, ClockSource &c)
+    : clock(c), tickMs(resolutionMs ? resolutionMs : 1), slots(slotCount ? slotCount : 1, NONE), freeList(NONE),
+      currentTick(0), timeouts(0), running(false) {
+    for (size_t s = 0; s < STATE_COUNT; s++) budgets[s] = budgetMs;
+    budgets[static_cast<size_t>(SystemState::IDLE)] = 0;
+    budgets[static_cast<size_t>(SystemState::STOPPED)] = 0;
+    currentTick = nowTick();
+}
+
+Watchdog::~Watchdog() { stop(); }
+
+uint64_t Watchdog::nowTick() const { return clock.nanos() / NANOS_PER_MILLI / tickMs; }
+
+void Watchdog::setBudget(SystemState state, uint32_t budgetMs) {
+    lock_guard<mutex> guard(lock);
+    budgets[static_cast<size_t>(state)] = budgetMs;
+}
+
+uint32_t Watchdog::getBudget(SystemState state) const {
+    lock_guard<mutex> guard(lock);
+    return budgets[static_cast<size_t>(state)];
+}
+
+// Masukkan entry ke slot deadline-nya
+void Watchdog::arm(uint32_t id, const Observation &o, uint64_t delayTicks) {
+    Entry &e = entries[id];
+    e.heartbeat = o.heartbeat;
+    e.state = o.state;
+    e.deadlineTick = currentTick + (delayTicks ? delayTicks : 1);
+    size_t slot = e.deadlineTick % slots.size();
+    e.next = slots[slot];
+    slots[slot] = id;
+}
+
+// State tanpa budget dicek lagi setelah budget terkecil, supaya state berikutnya yang diawasi tidak terlambat dilihat
+uint64_t Watchdog::unwatchedTicks() const {
+    uint32_t smallest = 0;
+    for (uint32_t budget : budgets) {
+        if (budget && (smallest == 0 || budget < smallest)) smallest = budget;
+    }
+    return smallest ? smallest / tickMs : slots.size();
+}
+
+uint32_t Watchdog::watch(FSM &fsm) {
+    lock_guard<mutex> guard(lock);
+    uint32_t id;
+    if (freeList != NONE) {
+        id = freeList;
+        freeList = entries[id].next;
+    } else {
+        id = static_cast<uint32_t>(entries.size());
+        entries.push_back(Entry());
+    }
+    entries[id].fsm = &fsm;
+    entries[id].fired = false;
+    arm(id, fsm.observe(), 1);
+    return id;
+}
+
+// Entry dibebaskan saat slot-nya dikunjungi
+void Watchdog::unwatch(uint32_t id) {
+    lock_guard<mutex> guard(lock);
+    if (id < entries.size()) entries[id].fsm = nullptr;
+}
+
+// Cek satu entry yang deadline-nya tiba, lalu pasang lagi
+void Watchdog::visit(uint32_t id, uint32_t nowMs) {
+    Entry &e = entries[id];
+    if (!e.fsm) {
+        e.next = freeList;
+        freeList = id;
+        return;
+    }
+    Observation o = e.fsm->observe();
+    if (o.heartbeat != e.heartbeat || o.state != e.state) e.fired = false;
+    uint32_t budget = budgets[static_cast<size_t>(o.state)];
+    int32_t elapsed = static_cast<int32_t>(nowMs - o.heartbeat);
+    uint32_t age = elapsed > 0 ? static_cast<uint32_t>(elapsed) : 0;
+    if (budget == 0 || e.fired) {
+        arm(id, o, budget ? budget / tickMs : unwatchedTicks());
+        return;
+    }
+    if (age >= budget) {
+        e.fsm->requestError();
+        e.fired = true;
+        timeouts++;
+        arm(id, o, budget / tickMs);
+        return;
+    }
+    arm(id, o, (budget - age + tickMs - 1) / tickMs);
+}
+
+// Proses setiap tick sampai target, selisih lebih dari satu putaran cukup satu putaran
+void Watchdog::advance(uint64_t target) {
+    if (target <= currentTick) return;
+    if (target - currentTick > slots.size()) currentTick = target - slots.size();
+    uint32_t nowMs = static_cast<uint32_t>(clock.nanos() / NANOS_PER_MILLI);
+    while (currentTick < target) {
+        currentTick++;
+        size_t slot = currentTick % slots.size();
+        uint32_t id = slots[slot];
+        slots[slot] = NONE;
+        while (id != NONE) {
+            uint32_t next = entries[id].next;
+            if (entries[id].deadlineTick > currentTick) {
+                entries[id].next = slots[slot];
+                slots[slot] = id;
+            } else {
+                visit(id, nowMs);
+            }
+            id = next;
+        }
+    }
+}
+
+void Watchdog::tick() {
+    lock_guard<mutex> guard(lock);
+    advance(nowTick());
+}
+
+void Watchdog::start() {
+    if (running.exchange(true)) return;
+    worker = thread([this] {
+        while (running.load(memory_order_acquire)) {
+            tick();
+            this_thread::sleep_for(chrono::milliseconds(tickMs));
+        }
+    });
+}
+
+void Watchdog::stop() {
+    if (!running.exchange(false)) return;
+    if (worker.joinable()) worker.join();
+}
+
+uint64_t Watchdog::getTimeouts() const {
+    lock_guard<mutex> guard(lock);
+    return timeouts;
+}
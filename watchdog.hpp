@@ -0,0 +1,109 @@
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "state.hpp"
+#include "clock.hpp"
+#include "observation.hpp"
+
+using namespace std;
+
+class FSM;
+
+/**
+ * @brief Heartbeat watchdog forcing SystemState::ERROR on FSMs whose handler stalls.
+ * Each watched FSM has one deadline, lastHeartbeat plus the budget of its state, kept in a hashed timer wheel.
+ * A tick only visits the deadlines falling in its slot, so watching thousands of FSMs costs O(1) per tick.
+ * On a visit, a new heartbeat re-arms the deadline, an old one past the budget calls FSM::requestError(),
+ * and the next update() of the FSM goes through performErrorHandling() and its escalation to STOPPED.
+ * An FSM in a state without budget (IDLE, STOPPED) is visited again after the smallest budget, so a stall
+ * right after it leaves IDLE is still caught about one tick after the budget of the new state.
+ * A coroutine handler suspended on sleepMillis(), skipTicks() or nextEvent() refreshes the heartbeat on every update(),
+ * so only an FSM that stops being updated or a body blocking inside one update() times out.
+ * @note The heartbeats are read through FSM::observe(), the watchdog never blocks the control threads.
+ * Its own methods are safe to call from any thread. Make sure the clock is the one used by the FSMs.
+ */
+class Watchdog {
+
+        private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        struct Entry {
+                FSM *fsm;               // Watched FSM, null once unwatched
+                uint64_t deadlineTick;  // Wheel tick at which the entry is visited
+                uint32_t heartbeat;     // Heartbeat seen when armed
+                SystemState state;      // State seen when armed
+                bool fired;             // requestError() was called for this heartbeat
+                uint32_t next;          // Next entry in the same slot or free list
+        };
+
+        ClockSource &clock;
+        uint32_t tickMs;                        // Wheel resolution
+        uint32_t budgets[STATE_COUNT];          // Heartbeat budget per state in milliseconds, 0 to not watch the state
+        vector<uint32_t> slots;                 // Head entry of each wheel slot
+        vector<Entry> entries;
+        uint32_t freeList;                      // Head of the unused entries
+        uint64_t currentTick;                   // Last wheel tick processed
+        uint64_t timeouts;                      // Number of requestError() calls
+        mutable mutex lock;                     // Serializes the watchdog users, never taken by a control thread
+        thread worker;
+        atomic<bool> running;
+
+        uint64_t nowTick() const;
+        void arm(uint32_t id, const Observation &o, uint64_t delayTicks);
+        uint64_t unwatchedTicks() const;
+        void visit(uint32_t id, uint32_t nowMs);
+        void advance(uint64_t target);
+
+        public:
+        /**
+         * @brief Create a watchdog.
+         * @param budgetMs Budget of INIT, MOVEMENT, SHOOTING, CALCULATION and ERROR, IDLE and STOPPED are not watched. 0 watches nothing.
+         * @param tickMs Wheel resolution, a stall is detected at most about one tick late.
+         * @param slots Number of wheel slots, deadlines further than slots ticks away take several turns.
+         * @param clock Time source, the same as the watched FSMs.
+         */
+        explicit Watchdog(uint32_t budgetMs = 0, uint32_t tickMs = 10, size_t slots = 512, ClockSource &clock = SteadyClock::instance());
+        ~Watchdog();
+
+        /**
+         * @brief Set the heartbeat budget of a state.
+         * @param budgetMs Maximum age of lastHeartbeat in that state, 0 to not watch it.
+         * @note Applies to each FSM from its next re-arm.
+         */
+        void setBudget(SystemState state, uint32_t budgetMs);
+        uint32_t getBudget(SystemState state) const;
+
+        /**
+         * @brief Start watching an FSM.
+         * @return The id to pass to unwatch().
+         * @note The FSM is not copied, it must stay alive until unwatch() or the watchdog is destroyed.
+         */
+        uint32_t watch(FSM &fsm);
+
+        /**
+         * @brief Stop watching an FSM.
+         */
+        void unwatch(uint32_t id);
+
+        /**
+         * @brief Process every wheel tick up to now.
+         * Call it periodically from a monitor thread, or use start() to get one.
+         */
+        void tick();
+
+        /**
+         * @brief Call tick() every tickMs from a background thread until stop() or destruction.
+         */
+        void start();
+        void stop();
+
+        uint64_t getTimeouts() const;
+};
+
+#endif // WATCHDOG_H_